@@ -0,0 +1,35 @@
+#include "AllocationCounter.hpp"
+#include <cstdlib>
+#include <new>
+
+namespace AllocationCounter {
+  // Per thread so counting never contends with the debugger's own threads
+  static thread_local uint64_t thread_allocations = 0;
+
+  uint64_t GetThreadAllocations() {
+    return thread_allocations;
+  }
+}
+
+// Replacing the two base forms is enough, the default array and nothrow
+//   versions forward to them. Aligned allocations are left to the runtime.
+void* operator new(std::size_t size) {
+  AllocationCounter::thread_allocations++;
+  if (size == 0) size = 1;
+  while (true) {
+    if (void* p = std::malloc(size))
+      return p;
+    std::new_handler handler = std::get_new_handler();
+    if (!handler)
+      throw std::bad_alloc();
+    handler();
+  }
+}
+
+void operator delete(void* p) noexcept {
+  std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+  std::free(p);
+}
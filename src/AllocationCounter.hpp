@@ -0,0 +1,11 @@
+#ifndef ALLOCATION_COUNTER_HPP
+#define ALLOCATION_COUNTER_HPP
+#include <cstdint>
+
+// Counts global operator new calls made by the calling thread. Lets the UI
+//   report how many heap allocations a frame performs.
+namespace AllocationCounter {
+  uint64_t GetThreadAllocations();
+}
+
+#endif
@@ -8,6 +8,23 @@ namespace lldb_frontend {
       .help("The program you wish to debug");
     parser.add_argument("--autoexec")
       .help("Script file containing autoexec instructions");
+    parser.add_argument("--trace")
+      .help("Record a Chrome trace (chrome://tracing, Perfetto) and write it to this file on exit");
+    parser.add_argument("--bench-stops")
+      .scan<'i', int>()
+      .help("Run the headless stop latency benchmark with this many stops and exit");
+    parser.add_argument("--bench-stacks")
+      .scan<'i', int>()
+      .help("Run the headless stack snapshot benchmark with this many parked threads and exit");
+    parser.add_argument("--bench-tracepoints")
+      .scan<'i', int>()
+      .help("Run the headless tracepoint throughput benchmark with this many hits and exit");
+    parser.add_argument("--bench-formatters")
+      .scan<'i', int>()
+      .help("Run the headless Locals formatter benchmark with containers this large and exit");
+    parser.add_argument("--bench-memdiff")
+      .scan<'i', int>()
+      .help("Run the pinned memory diff benchmark over this many MiB and exit");
     parser.add_argument("--")
       .remaining()
       .help("Arguments to forward");
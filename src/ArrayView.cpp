@@ -0,0 +1,285 @@
+#include "ArrayView.hpp"
+#include "Logger.hpp"
+#include "Trace.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <type_traits>
+#include <fmt/core.h>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ARRAY_VIEW_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace {
+  template <typename T>
+  ArrayView::Stats ScalarStats(const T* data, uint64_t count) {
+    // Plain loop, compilers vectorize the integer cases on their own
+    T min = data[0], max = data[0];
+    double sum = 0.0;
+    for (uint64_t i = 0; i < count; i++) {
+      min = data[i] < min ? data[i] : min;
+      max = data[i] > max ? data[i] : max;
+      sum += (double)data[i];
+    }
+    return ArrayView::Stats{(double)min, (double)max, sum / count, 0.f};
+  }
+
+#ifdef ARRAY_VIEW_SSE2
+  ArrayView::Stats FloatStats(const float* data, uint64_t count) {
+    __m128 min = _mm_set1_ps(data[0]), max = min;
+    __m128d sum_low = _mm_setzero_pd(), sum_high = _mm_setzero_pd();
+    uint64_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+      __m128 v = _mm_loadu_ps(data + i);
+      min = _mm_min_ps(min, v);
+      max = _mm_max_ps(max, v);
+      // Summed as doubles, a float sum drifts long before a million elements
+      sum_low = _mm_add_pd(sum_low, _mm_cvtps_pd(v));
+      sum_high = _mm_add_pd(sum_high, _mm_cvtps_pd(_mm_movehl_ps(v, v)));
+    }
+    float mins[4], maxs[4];
+    double sums[2];
+    _mm_storeu_ps(mins, min);
+    _mm_storeu_ps(maxs, max);
+    _mm_storeu_pd(sums, _mm_add_pd(sum_low, sum_high));
+    float lo = std::min<float>(std::min<float>(mins[0], mins[1]), std::min<float>(mins[2], mins[3]));
+    float hi = std::max<float>(std::max<float>(maxs[0], maxs[1]), std::max<float>(maxs[2], maxs[3]));
+    double sum = sums[0] + sums[1];
+    for (; i < count; i++) {
+      lo = std::min<float>(lo, data[i]);
+      hi = std::max<float>(hi, data[i]);
+      sum += data[i];
+    }
+    return ArrayView::Stats{lo, hi, sum / count, 0.f};
+  }
+
+  ArrayView::Stats DoubleStats(const double* data, uint64_t count) {
+    __m128d min = _mm_set1_pd(data[0]), max = min, sum = _mm_setzero_pd();
+    uint64_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+      __m128d v = _mm_loadu_pd(data + i);
+      min = _mm_min_pd(min, v);
+      max = _mm_max_pd(max, v);
+      sum = _mm_add_pd(sum, v);
+    }
+    double mins[2], maxs[2], sums[2];
+    _mm_storeu_pd(mins, min);
+    _mm_storeu_pd(maxs, max);
+    _mm_storeu_pd(sums, sum);
+    double lo = std::min<double>(mins[0], mins[1]);
+    double hi = std::max<double>(maxs[0], maxs[1]);
+    double total = sums[0] + sums[1];
+    for (; i < count; i++) {
+      lo = std::min<double>(lo, data[i]);
+      hi = std::max<double>(hi, data[i]);
+      total += data[i];
+    }
+    return ArrayView::Stats{lo, hi, total / count, 0.f};
+  }
+#else
+  ArrayView::Stats FloatStats(const float* data, uint64_t count) { return ScalarStats(data, count); }
+  ArrayView::Stats DoubleStats(const double* data, uint64_t count) { return ScalarStats(data, count); }
+#endif
+}
+
+std::optional<ArrayView::ElementKind> ArrayView::GetElementKind(lldb::SBType type) {
+  type = type.GetCanonicalType();
+  const uint64_t size = type.GetByteSize();
+  switch (type.GetBasicType()) {
+    case lldb::eBasicTypeBool: return ElementKind::Bool;
+    case lldb::eBasicTypeFloat: return ElementKind::F32;
+    case lldb::eBasicTypeDouble: return ElementKind::F64;
+    case lldb::eBasicTypeChar:
+    case lldb::eBasicTypeSignedChar:
+    case lldb::eBasicTypeShort:
+    case lldb::eBasicTypeInt:
+    case lldb::eBasicTypeLong:
+    case lldb::eBasicTypeLongLong:
+    case lldb::eBasicTypeWChar:
+    case lldb::eBasicTypeSignedWChar:
+      // long and wchar_t differ in size between platforms
+      switch (size) {
+        case 1: return ElementKind::I8;
+        case 2: return ElementKind::I16;
+        case 4: return ElementKind::I32;
+        case 8: return ElementKind::I64;
+      }
+      return std::nullopt;
+    case lldb::eBasicTypeUnsignedChar:
+    case lldb::eBasicTypeChar8:
+    case lldb::eBasicTypeUnsignedShort:
+    case lldb::eBasicTypeUnsignedInt:
+    case lldb::eBasicTypeUnsignedLong:
+    case lldb::eBasicTypeUnsignedLongLong:
+    case lldb::eBasicTypeUnsignedWChar:
+    case lldb::eBasicTypeChar16:
+    case lldb::eBasicTypeChar32:
+      switch (size) {
+        case 1: return ElementKind::U8;
+        case 2: return ElementKind::U16;
+        case 4: return ElementKind::U32;
+        case 8: return ElementKind::U64;
+      }
+      return std::nullopt;
+    default:
+      return std::nullopt;
+  }
+}
+
+size_t ArrayView::GetElementSize(ElementKind kind) {
+  switch (kind) {
+    case ElementKind::I8: case ElementKind::U8: case ElementKind::Bool: return 1;
+    case ElementKind::I16: case ElementKind::U16: return 2;
+    case ElementKind::I32: case ElementKind::U32: case ElementKind::F32: return 4;
+    case ElementKind::I64: case ElementKind::U64: case ElementKind::F64: return 8;
+  }
+  return 1;
+}
+
+std::optional<ArrayView::Source> ArrayView::Recognize(lldb::SBValue value) {
+  // The raw members, not the children the formatters make up
+  lldb::SBValue raw = value.GetNonSyntheticValue();
+  lldb::SBType type = raw.GetType().GetCanonicalType();
+  if (!type.IsValid()) return std::nullopt;
+
+  // std::array wraps a C array
+  if (!type.IsArrayType()) {
+    for (const char* member : {"_M_elems", "__elems_", "_Elems"}) {
+      lldb::SBValue elems = raw.GetChildMemberWithName(member);
+      if (elems.IsValid() && elems.GetType().GetCanonicalType().IsArrayType()) {
+        raw = elems;
+        type = elems.GetType().GetCanonicalType();
+        break;
+      }
+    }
+  }
+  if (type.IsArrayType()) {
+    lldb::SBType element = type.GetArrayElementType();
+    auto kind = GetElementKind(element);
+    const uint64_t element_size = element.GetByteSize();
+    if (!kind || element_size == 0 || raw.GetLoadAddress() == LLDB_INVALID_ADDRESS) return std::nullopt;
+    return Source{raw.GetLoadAddress(), type.GetByteSize() / element_size, *kind, element.GetDisplayTypeName() ? element.GetDisplayTypeName() : "?"};
+  }
+
+  // std::vector is a begin and an end pointer, wherever the implementation keeps them
+  static const char* const VectorMembers[][2] = {
+    {"_M_impl._M_start", "_M_impl._M_finish"},
+    {"__begin_", "__end_"},
+    {"_Mypair._Myval2._Myfirst", "_Mypair._Myval2._Mylast"},
+  };
+  for (const auto& [begin_path, end_path] : VectorMembers) {
+    lldb::SBValue begin = raw.GetValueForExpressionPath(fmt::format(".{}", begin_path).c_str());
+    lldb::SBValue end = raw.GetValueForExpressionPath(fmt::format(".{}", end_path).c_str());
+    if (!begin.IsValid() || !end.IsValid() || !begin.GetType().IsPointerType()) continue;
+    lldb::SBType element = begin.GetType().GetPointeeType();
+    auto kind = GetElementKind(element);
+    // vector<bool> is a bitset, its pointers aren't to bool
+    if (!kind) return std::nullopt;
+    const lldb::addr_t first = begin.GetValueAsUnsigned();
+    const lldb::addr_t last = end.GetValueAsUnsigned();
+    const uint64_t element_size = GetElementSize(*kind);
+    if (last < first || (last - first) % element_size != 0) return std::nullopt;
+    return Source{first, (last - first) / element_size, *kind, element.GetDisplayTypeName() ? element.GetDisplayTypeName() : "?"};
+  }
+  return std::nullopt;
+}
+
+bool ArrayView::Read(lldb::SBProcess process, const Source& read_source, const std::string& value_name) {
+  Trace::Scope t("Read Array", "memory");
+  auto start = std::chrono::steady_clock::now();
+  const uint64_t size = read_source.count * GetElementSize(read_source.kind);
+  if (size > MaxBytes) {
+    Logger::Err("{} is {} MiB, more than the {} MiB an array view reads", value_name, size >> 20, MaxBytes >> 20);
+    return false;
+  }
+
+  bytes.resize(size);
+  lldb::SBError error;
+  const size_t read = size ? process.ReadMemory(read_source.address, bytes.data(), size, error) : 0;
+  if (size && (error.Fail() || read != size)) {
+    Logger::Err("Failed to read {} bytes of {} at 0x{:x}: {}", size, value_name, read_source.address, error.GetCString() ? error.GetCString() : "short read");
+    Reset();
+    return false;
+  }
+
+  valid = true;
+  name = value_name;
+  source = read_source;
+  stopId = process.GetStopID();
+  stats.reset();
+  readMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+  Logger::Info("Read {} x {} of {} in {:.2f} ms", source.count, source.element_type, name, readMs);
+  return true;
+}
+
+void ArrayView::Reset() {
+  valid = false;
+  bytes.clear();
+  bytes.shrink_to_fit();
+  stats.reset();
+}
+
+bool ArrayView::IsValid() const { return valid; }
+const std::string& ArrayView::GetName() const { return name; }
+const ArrayView::Source& ArrayView::GetSource() const { return source; }
+uint64_t ArrayView::GetCount() const { return valid ? source.count : 0; }
+uint32_t ArrayView::GetStopId() const { return stopId; }
+float ArrayView::GetReadMs() const { return readMs; }
+
+size_t ArrayView::FormatElement(uint64_t index, char* out, size_t size) const {
+  auto load = [&]<typename T>(T) {
+    T v;
+    std::memcpy(&v, bytes.data() + index * sizeof(T), sizeof(T));
+    return v;
+  };
+  fmt::format_to_n_result<char*> result;
+  switch (source.kind) {
+    case ElementKind::I8: result = fmt::format_to_n(out, size, "{}", (int)load(int8_t{})); break;
+    case ElementKind::U8: result = fmt::format_to_n(out, size, "{}", (unsigned)load(uint8_t{})); break;
+    case ElementKind::I16: result = fmt::format_to_n(out, size, "{}", load(int16_t{})); break;
+    case ElementKind::U16: result = fmt::format_to_n(out, size, "{}", load(uint16_t{})); break;
+    case ElementKind::I32: result = fmt::format_to_n(out, size, "{}", load(int32_t{})); break;
+    case ElementKind::U32: result = fmt::format_to_n(out, size, "{}", load(uint32_t{})); break;
+    case ElementKind::I64: result = fmt::format_to_n(out, size, "{}", load(int64_t{})); break;
+    case ElementKind::U64: result = fmt::format_to_n(out, size, "{}", load(uint64_t{})); break;
+    case ElementKind::F32: result = fmt::format_to_n(out, size, "{}", load(float{})); break;
+    case ElementKind::F64: result = fmt::format_to_n(out, size, "{}", load(double{})); break;
+    case ElementKind::Bool: result = fmt::format_to_n(out, size, "{}", load(uint8_t{}) != 0); break;
+  }
+  const size_t length = std::min<size_t>(result.size, size - 1);
+  out[length] = '\0';
+  return length;
+}
+
+const ArrayView::Stats& ArrayView::GetStats() {
+  if (stats) return *stats;
+  Trace::Scope t("Array Stats", "memory");
+  auto start = std::chrono::steady_clock::now();
+  Stats computed{};
+  const uint64_t count = GetCount();
+  if (count > 0) {
+    // The buffer comes from operator new, which aligns it for any scalar
+    auto typed = [&]<typename T>(T) {
+      const T* values = reinterpret_cast<const T*>(bytes.data());
+      if constexpr (std::is_same_v<T, float>) return FloatStats(values, count);
+      else if constexpr (std::is_same_v<T, double>) return DoubleStats(values, count);
+      else return ScalarStats(values, count);
+    };
+    switch (source.kind) {
+      case ElementKind::I8: computed = typed(int8_t{}); break;
+      case ElementKind::U8: case ElementKind::Bool: computed = typed(uint8_t{}); break;
+      case ElementKind::I16: computed = typed(int16_t{}); break;
+      case ElementKind::U16: computed = typed(uint16_t{}); break;
+      case ElementKind::I32: computed = typed(int32_t{}); break;
+      case ElementKind::U32: computed = typed(uint32_t{}); break;
+      case ElementKind::I64: computed = typed(int64_t{}); break;
+      case ElementKind::U64: computed = typed(uint64_t{}); break;
+      case ElementKind::F32: computed = typed(float{}); break;
+      case ElementKind::F64: computed = typed(double{}); break;
+    }
+  }
+  computed.ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+  stats = computed;
+  return *stats;
+}
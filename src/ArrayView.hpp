@@ -0,0 +1,63 @@
+#ifndef ARRAY_VIEW_HPP
+#define ARRAY_VIEW_HPP
+#include <lldb/API/LLDB.h>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <vector>
+
+// The elements of an array or contiguous container of scalars, read from the
+//   process with a single ReadMemory instead of one SBValue per element.
+//   Elements are only decoded when they're shown
+class ArrayView {
+  public:
+    static constexpr uint64_t MaxBytes = 256ull << 20;
+
+    enum class ElementKind { I8, U8, I16, U16, I32, U32, I64, U64, F32, F64, Bool };
+    // Where the elements live, found from the value's type
+    struct Source {
+      lldb::addr_t address;
+      uint64_t count;
+      ElementKind kind;
+      std::string element_type;
+    };
+    struct Stats {
+      double min;
+      double max;
+      double mean;
+      float ms;
+    };
+
+  public:
+    // C arrays, std::array and std::vector (libstdc++, libc++ and MSVC) of
+    //   integers, floating point or bool
+    static std::optional<Source> Recognize(lldb::SBValue value);
+    bool Read(lldb::SBProcess process, const Source& source, const std::string& name);
+    void Reset();
+
+    bool IsValid() const;
+    const std::string& GetName() const;
+    const Source& GetSource() const;
+    uint64_t GetCount() const;
+    uint32_t GetStopId() const;
+    float GetReadMs() const;
+    // Writes the element at index as text into out, returns its length
+    size_t FormatElement(uint64_t index, char* out, size_t size) const;
+    // Computed on first use and kept until the next Read
+    const Stats& GetStats();
+
+  private:
+    static std::optional<ElementKind> GetElementKind(lldb::SBType type);
+    static size_t GetElementSize(ElementKind kind);
+
+  private:
+    bool valid = false;
+    std::string name;
+    Source source{};
+    uint32_t stopId = 0;
+    float readMs = 0.f;
+    std::vector<std::byte> bytes;
+    std::optional<Stats> stats;
+};
+
+#endif
@@ -0,0 +1,275 @@
+#include "Benchmark.hpp"
+#include "LLDBDebugger.hpp"
+#include "FileHierarchy.hpp"
+#include "StopLatency.hpp"
+#include "RingBuffer.hpp"
+#include "Logger.hpp"
+#include "Util.hpp"
+#include "Stacks.hpp"
+#include "VariableTree.hpp"
+#include "Formatters.hpp"
+#include "MemorySnapshots.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+
+namespace lldb_frontend {
+  using Clock = std::chrono::steady_clock;
+
+  bool Benchmark::CreateTestTarget(LLDBDebugger& debugger) {
+    std::filesystem::path executable = Util::GetCurrentProgramDirectory() / "lldb-frontend-test";
+#ifdef _WIN32
+    executable += ".exe";
+#endif
+    debugger.SetTarget(debugger.GetDebugger().CreateTarget(executable.string().c_str()));
+    if (!debugger.GetTarget().IsValid()) {
+      Logger::Err("Failed to create target '{}'", executable.string());
+      return false;
+    }
+    return true;
+  }
+
+  bool Benchmark::WaitForStop(LLDBDebugger& debugger, uint64_t handed_off_count) {
+    auto deadline = Clock::now() + std::chrono::seconds(60);
+    while (StopLatency::GetHandedOffCount() <= handed_off_count) {
+      if (Clock::now() > deadline) return false;
+      auto state = debugger.GetProcess().GetState();
+      if (state == lldb::eStateExited || state == lldb::eStateCrashed) return false;
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    return true;
+  }
+
+  int Benchmark::RunStopLatency(int iterations) {
+    Logger::ScopedGroup g("Stop Latency Benchmark");
+
+    std::mutex files_mutex;
+    std::vector<std::filesystem::path> files;
+    LLDBDebugger debugger;
+    debugger.SetEventCallback([&](const LLDBDebugger::Event& event) {
+      // No UI to hand anything to, only the indexed files matter
+      if (auto e = std::get_if<LLDBDebugger::Event::AddFiles>(&event.data)) {
+        std::lock_guard lock(files_mutex);
+        files.insert(files.end(), e->paths.begin(), e->paths.end());
+      }
+    });
+
+    if (!CreateTestTarget(debugger))
+      return 1;
+    debugger.IndexTarget(debugger.GetTarget()).wait();
+
+    FileHierarchy fh;
+    {
+      std::lock_guard lock(files_mutex);
+      for (const auto& file : files)
+        fh.AddFile(file);
+    }
+    fh.ComputeTree();
+
+    // Inside the countdown loop, so every continue lands on it again
+    if (debugger.ExecCommand("b test.cpp:28", fh).status != LLDBDebugger::ExecResultStatus::Ok) {
+      Logger::Err("Failed to set the benchmark breakpoint");
+      return 1;
+    }
+
+    RingBuffer<float, StopLatency::HistoryLength> round_trip_ms;
+    uint64_t stops = StopLatency::GetHandedOffCount();
+    debugger.LaunchTarget(std::vector<std::string>{std::to_string(iterations)});
+    if (!WaitForStop(debugger, stops)) {
+      Logger::Err("Debuggee never reached the breakpoint");
+      return 1;
+    }
+
+    int completed = 0;
+    for (int i = 0; i < iterations; i++) {
+      stops = StopLatency::GetHandedOffCount();
+      auto start = Clock::now();
+      // Alternate between the two ways a stop usually comes about
+      if (i % 2 == 0) debugger.Continue();
+      else            debugger.StepOver();
+      if (!WaitForStop(debugger, stops)) break;
+      round_trip_ms.Push(std::chrono::duration<float, std::milli>(Clock::now() - start).count());
+      completed++;
+    }
+    debugger.GetProcess().Kill();
+
+    auto hand_off = StopLatency::GetHandOffHistory();
+    std::cout << fmt::format("stops: {}\n", completed);
+    std::cout << fmt::format("stop -> hand off: p50 {:.3f} ms | p99 {:.3f} ms\n",
+      hand_off.Percentile(0.5f), hand_off.Percentile(0.99f));
+    std::cout << fmt::format("command -> stop:  p50 {:.3f} ms | p99 {:.3f} ms\n",
+      round_trip_ms.Percentile(0.5f), round_trip_ms.Percentile(0.99f));
+    return completed > 0 ? 0 : 1;
+  }
+
+  int Benchmark::RunStackSnapshot(int threads) {
+    Logger::ScopedGroup g("Stack Snapshot Benchmark");
+    LLDBDebugger debugger;
+    debugger.SetEventCallback([](const LLDBDebugger::Event&) {});
+    if (!CreateTestTarget(debugger))
+      return 1;
+    debugger.GetTarget().BreakpointCreateByName("ThreadsParked");
+
+    // No countdown, straight to parking the threads
+    uint64_t stops = StopLatency::GetHandedOffCount();
+    debugger.LaunchTarget(std::vector<std::string>{"0", std::to_string(threads)});
+    if (!WaitForStop(debugger, stops)) {
+      Logger::Err("Debuggee never parked its threads");
+      return 1;
+    }
+
+    // The first pass also pays for parsing the unwind info, keep it out of the numbers
+    auto process = debugger.GetProcess();
+    Stacks::Collect(process);
+    constexpr int Runs = 10;
+    RingBuffer<float, Runs> parallel_ms, serial_ms, group_ms;
+    size_t groups = 0, workers = 0, thread_count = 0;
+    for (int i = 0; i < Runs; i++) {
+      auto parallel = Stacks::Collect(process);
+      parallel_ms.Push(parallel.collect_ms);
+      group_ms.Push(parallel.group_ms);
+      serial_ms.Push(Stacks::Collect(process, 1).collect_ms);
+      groups = parallel.groups.size();
+      workers = parallel.worker_count;
+      thread_count = parallel.thread_count;
+    }
+    process.Kill();
+
+    std::cout << fmt::format("threads: {} | unique stacks: {}\n", thread_count, groups);
+    std::cout << fmt::format("unwind ({} workers): p50 {:.2f} ms\n", workers, parallel_ms.Percentile(0.5f));
+    std::cout << fmt::format("unwind (1 worker):  p50 {:.2f} ms\n", serial_ms.Percentile(0.5f));
+    std::cout << fmt::format("grouping:           p50 {:.2f} ms\n", group_ms.Percentile(0.5f));
+    return 0;
+  }
+
+  int Benchmark::RunTracepoints(int iterations) {
+    Logger::ScopedGroup g("Tracepoint Benchmark");
+    LLDBDebugger debugger;
+    debugger.SetEventCallback([](const LLDBDebugger::Event&) {});
+    if (!CreateTestTarget(debugger))
+      return 1;
+    auto& tracepoints = debugger.GetTracepoints();
+    if (tracepoints.Add(debugger.GetTarget(), "test.cpp", 28, "x = {x}") == LLDB_INVALID_BREAK_ID)
+      return 1;
+
+    auto start = Clock::now();
+    debugger.LaunchTarget(std::vector<std::string>{std::to_string(iterations)});
+    auto deadline = start + std::chrono::minutes(10);
+    while (debugger.GetProcess().IsValid() && debugger.GetProcess().GetState() != lldb::eStateExited) {
+      if (Clock::now() > deadline) {
+        Logger::Err("Debuggee did not exit in time");
+        return 1;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    const float seconds = std::chrono::duration<float>(Clock::now() - start).count();
+    const uint64_t hits = tracepoints.GetTotalHits();
+
+    std::vector<std::string> last;
+    tracepoints.CopyLogLines(tracepoints.GetLogLineCount() - 1, 1, last);
+    std::cout << fmt::format("hits: {} in {:.2f} s (launch included)\n", hits, seconds);
+    std::cout << fmt::format("rate: {:.0f} hits/s | {:.1f} us/hit\n", hits / seconds, seconds * 1e6f / std::max<uint64_t>(hits, 1));
+    if (!last.empty())
+      std::cout << fmt::format("last: {}\n", last[0]);
+    return hits == (uint64_t)iterations ? 0 : 1;
+  }
+
+  int Benchmark::RunFormatters(int elements) {
+    Logger::ScopedGroup g("Formatter Benchmark");
+    LLDBDebugger debugger;
+    debugger.SetEventCallback([](const LLDBDebugger::Event&) {});
+    if (!CreateTestTarget(debugger))
+      return 1;
+    debugger.GetTarget().BreakpointCreateByName("ContainersBuilt");
+
+    uint64_t stops = StopLatency::GetHandedOffCount();
+    debugger.LaunchTarget(std::vector<std::string>{"0", "0", std::to_string(elements)});
+    if (!WaitForStop(debugger, stops)) {
+      Logger::Err("Debuggee never built its containers");
+      return 1;
+    }
+    // The containers are locals of the caller
+    auto process = debugger.GetProcess();
+    process.GetSelectedThread().SetSelectedFrame(1);
+
+    // Expands every variable in full and each of their children one page deep,
+    //   the way a user digging through Locals would
+    struct Result {
+      float ms;
+      size_t nodes;
+    };
+    auto expand = [&](bool native) {
+      Formatters::SetAllEnabled(native);
+      VariableTree tree;
+      auto start = Clock::now();
+      tree.Update(process);
+      for (uint32_t root : tree.GetRoots()) {
+        if (!tree.GetNode(root).might_have_children) continue;
+        do tree.FetchPage(root); while (tree.GetNode(root).has_more);
+        const auto children = tree.GetNode(root).children;
+        for (uint32_t child : children)
+          if (tree.GetNode(child).might_have_children)
+            tree.FetchPage(child);
+      }
+      return Result{std::chrono::duration<float, std::milli>(Clock::now() - start).count(), tree.GetNodeCount()};
+    };
+
+    // LLDB caches synthetic children per value, so the first expansion of each
+    //   is reported on its own
+    const Result lldb_cold = expand(false);
+    const Result native_cold = expand(true);
+    constexpr int Runs = 5;
+    RingBuffer<float, Runs> lldb_ms, native_ms;
+    for (int i = 0; i < Runs; i++) {
+      lldb_ms.Push(expand(false).ms);
+      native_ms.Push(expand(true).ms);
+    }
+    Formatters::SetAllEnabled(true);
+    process.Kill();
+
+    std::cout << fmt::format("elements: {} | nodes: {} (LLDB) {} (built-in)\n", elements, lldb_cold.nodes, native_cold.nodes);
+    std::cout << fmt::format("LLDB formatters:     cold {:.2f} ms | warm p50 {:.2f} ms\n", lldb_cold.ms, lldb_ms.Percentile(0.5f));
+    std::cout << fmt::format("built-in formatters: cold {:.2f} ms | warm p50 {:.2f} ms\n", native_cold.ms, native_ms.Percentile(0.5f));
+    return 0;
+  }
+
+  int Benchmark::RunMemoryDiff(int megabytes) {
+    Logger::ScopedGroup g("Memory Diff Benchmark");
+    const uint64_t size = (uint64_t)std::clamp<int>(megabytes, 1, (int)(MemorySnapshots::MaxSize >> 20)) << 20;
+    std::vector<uint8_t> a(size), b;
+    uint64_t state = 0x9e3779b97f4a7c15ull;
+    for (uint64_t i = 0; i < size; i += 8) {
+      state ^= state << 13; state ^= state >> 7; state ^= state << 17;
+      memcpy(a.data() + i, &state, std::min<uint64_t>(8, size - i));
+    }
+    b = a;
+
+    constexpr int Runs = 9;
+    auto time = [&](size_t& ranges) {
+      RingBuffer<float, Runs> ms;
+      for (int i = 0; i < Runs; i++) {
+        auto start = Clock::now();
+        ranges = MemorySnapshots::Diff(a.data(), b.data(), size).size();
+        ms.Push(std::chrono::duration<float, std::milli>(Clock::now() - start).count());
+      }
+      return ms.Percentile(0.5f);
+    };
+    size_t unchanged_ranges = 0;
+    const float unchanged_ms = time(unchanged_ranges);
+    // A write every 4 KiB on average, a few bytes each
+    const size_t writes = size / 4096;
+    for (size_t i = 0; i < writes; i++) {
+      state ^= state << 13; state ^= state >> 7; state ^= state << 17;
+      const uint64_t offset = state % (size - 8);
+      for (uint64_t j = 0; j < 1 + state % 8; j++)
+        b[offset + j] ^= 0xff;
+    }
+    size_t changed_ranges = 0;
+    const float changed_ms = time(changed_ranges);
+
+    std::cout << fmt::format("size: {} MiB\n", size >> 20);
+    std::cout << fmt::format("unchanged: p50 {:.2f} ms ({:.1f} GiB/s) | {} ranges\n", unchanged_ms, size / (unchanged_ms / 1000.f) / (1 << 30), unchanged_ranges);
+    std::cout << fmt::format("scattered writes: p50 {:.2f} ms ({:.1f} GiB/s) | {} ranges\n", changed_ms, size / (changed_ms / 1000.f) / (1 << 30), changed_ranges);
+    return 0;
+  }
+}
@@ -0,0 +1,34 @@
+#ifndef BENCHMARK_HPP
+#define BENCHMARK_HPP
+#include <cstdint>
+
+class LLDBDebugger;
+
+namespace lldb_frontend {
+  // Headless runs against the bundled test debuggee, for catching regressions
+  //   without a window. Returns a process exit code
+  class Benchmark {
+    public:
+      // Steps the debuggee through `iterations` stops and reports the stop -> hand off
+      //   latency and the command -> stop round trip
+      static int RunStopLatency(int iterations);
+      // Parks `threads` threads 50 frames deep in the debuggee and times stack
+      //   snapshots of them, parallel and on a single worker
+      static int RunStackSnapshot(int threads);
+      // Runs the countdown loop `iterations` times with a tracepoint inside it
+      //   and reports how many hits per second it sustains
+      static int RunTracepoints(int iterations);
+      // Stops with standard containers of `elements` elements in scope and
+      //   times expanding all of them with the built-in and LLDB's formatters
+      static int RunFormatters(int elements);
+      // Diffs two `megabytes` buffers the way a pinned range is diffed between
+      //   stops, unchanged and with scattered writes. No debuggee involved
+      static int RunMemoryDiff(int megabytes);
+
+    private:
+      static bool CreateTestTarget(LLDBDebugger&);
+      static bool WaitForStop(LLDBDebugger&, uint64_t handed_off_count);
+  };
+}
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef CONCURRENT_SET_HPP
+#define CONCURRENT_SET_HPP
+#include <array>
+#include <functional>
+#include <mutex>
+#include <unordered_set>
+
+// Hash set split into independently locked shards so several threads can
+//   insert at once without contending on a single mutex.
+template <typename T, typename Hash = std::hash<T>, size_t ShardCount = 16>
+class ConcurrentSet {
+  public:
+    // Returns true if the value was not in the set yet
+    bool Insert(const T& value) {
+      auto& shard = shards[Hash{}(value) % ShardCount];
+      std::lock_guard lock(shard.mutex);
+      return shard.values.insert(value).second;
+    }
+
+    size_t Size() {
+      size_t size = 0;
+      for (auto& shard : shards) {
+        std::lock_guard lock(shard.mutex);
+        size += shard.values.size();
+      }
+      return size;
+    }
+
+  private:
+    struct alignas(64) Shard {
+      std::mutex mutex;
+      std::unordered_set<T, Hash> values;
+    };
+    std::array<Shard, ShardCount> shards;
+};
+
+#endif
@@ -0,0 +1,145 @@
+#include "Disassembly.hpp"
+#include "Logger.hpp"
+#include "Trace.hpp"
+#include "Util.hpp"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <fmt/core.h>
+
+int32_t Disassembly::Listing::Find(lldb::addr_t address) const {
+  auto it = std::upper_bound(instructions.begin(), instructions.end(), address, [](lldb::addr_t a, const Instruction& i) { return a < i.address; });
+  if (it == instructions.begin()) return -1;
+  --it;
+  return address < it->address + std::max<uint32_t>(it->size, 1) ? (int32_t)(it - instructions.begin()) : -1;
+}
+
+std::shared_ptr<const Disassembly::Listing> Disassembly::Get(lldb::SBTarget target, lldb::addr_t pc) {
+  {
+    std::lock_guard lock(mutex);
+    auto it = listings.upper_bound(pc);
+    if (it != listings.begin()) {
+      --it;
+      if (pc < it->second.listing->end) {
+        it->second.used = ++useCounter;
+        hits++;
+        return it->second.listing;
+      }
+    }
+  }
+  misses++;
+  auto listing = Disassemble(target, pc);
+  if (!listing) return nullptr;
+
+  std::lock_guard lock(mutex);
+  listings[listing->start] = Entry{listing, ++useCounter};
+  if (listings.size() > Capacity) {
+    auto oldest = std::min_element(listings.begin(), listings.end(), [](const auto& a, const auto& b) { return a.second.used < b.second.used; });
+    listings.erase(oldest);
+  }
+  return listing;
+}
+
+void Disassembly::Clear() {
+  std::lock_guard lock(mutex);
+  listings.clear();
+}
+
+uint64_t Disassembly::GetHits() const {
+  return hits;
+}
+
+uint64_t Disassembly::GetMisses() const {
+  return misses;
+}
+
+size_t Disassembly::GetSize() {
+  std::lock_guard lock(mutex);
+  return listings.size();
+}
+
+std::shared_ptr<const Disassembly::Listing> Disassembly::Disassemble(lldb::SBTarget& target, lldb::addr_t pc) {
+  Trace::Scope t("Disassemble", "disassembly");
+  auto start = std::chrono::steady_clock::now();
+  lldb::SBAddress address = target.ResolveLoadAddress(pc);
+  if (!address.IsValid()) return nullptr;
+
+  auto listing = std::make_shared<Listing>();
+  lldb::SBInstructionList list;
+  lldb::SBFunction function = address.GetFunction();
+  lldb::SBSymbol symbol = address.GetSymbol();
+  if (function.IsValid()) {
+    listing->name = function.GetDisplayName() ? function.GetDisplayName() : "";
+    list = function.GetInstructions(target);
+  }
+  else if (symbol.IsValid()) {
+    listing->name = symbol.GetDisplayName() ? symbol.GetDisplayName() : "";
+    list = symbol.GetInstructions(target);
+  }
+  // Stripped code, or a symbol LLDB couldn't size
+  if (!list.IsValid() || list.GetSize() == 0) {
+    listing->name = fmt::format("0x{:x}", pc);
+    list = target.ReadInstructions(address, FallbackCount);
+  }
+  if (!list.IsValid() || list.GetSize() == 0) {
+    Logger::Warn("Disassembly: nothing to disassemble at 0x{:x}", pc);
+    return nullptr;
+  }
+
+  const size_t count = list.GetSize();
+  listing->instructions.reserve(count);
+  listing->mixed.reserve(count);
+  std::string last_file;
+  uint32_t last_line = 0;
+  for (size_t i = 0; i < count; i++) {
+    lldb::SBInstruction sb_instruction = list.GetInstructionAtIndex((uint32_t)i);
+    lldb::SBAddress instruction_address = sb_instruction.GetAddress();
+    Instruction instruction{
+      .address = instruction_address.GetLoadAddress(target),
+      .size = (uint32_t)sb_instruction.GetByteSize(),
+    };
+    if (const char* mnemonic = sb_instruction.GetMnemonic(target)) instruction.mnemonic = mnemonic;
+    if (const char* operands = sb_instruction.GetOperands(target)) instruction.operands = operands;
+    if (const char* comment = sb_instruction.GetComment(target)) instruction.comment = comment;
+
+    // A new source line whenever the line table moves to another file:line
+    lldb::SBLineEntry line_entry = instruction_address.GetLineEntry();
+    if (line_entry.IsValid() && line_entry.GetLine() != 0) {
+      lldb::SBFileSpec file = line_entry.GetFileSpec();
+      const char* filename = file.GetFilename();
+      if (line_entry.GetLine() != last_line || last_file != (filename ? filename : "")) {
+        last_line = line_entry.GetLine();
+        last_file = filename ? filename : "";
+        SourceLine source{.file = filename ? filename : "?", .line = line_entry.GetLine()};
+        if (filename && file.GetDirectory()) {
+          const std::string path = std::string(file.GetDirectory()) + Util::PathSeparator + filename;
+          if (auto lines = LoadSource(path); lines && source.line <= lines->size())
+            source.text = (*lines)[source.line - 1];
+        }
+        instruction.source = (uint32_t)listing->sources.size();
+        listing->mixed.push_back(SourceFlag | instruction.source);
+        listing->sources.push_back(std::move(source));
+      }
+    }
+    listing->mixed.push_back((uint32_t)listing->instructions.size());
+    listing->instructions.push_back(std::move(instruction));
+  }
+  listing->start = listing->instructions.front().address;
+  listing->end = listing->instructions.back().address + std::max<uint32_t>(listing->instructions.back().size, 1);
+  listing->ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+  Logger::Info("Disassembly: {} instructions of {} in {:.2f} ms", count, listing->name, listing->ms);
+  return listing;
+}
+
+const std::vector<std::string>* Disassembly::LoadSource(const std::string& path) {
+  auto it = sourceFiles.find(path);
+  if (it == sourceFiles.end()) {
+    // Missing files are cached as empty so they're only tried once
+    std::vector<std::string> lines;
+    std::ifstream in(path);
+    for (std::string line; std::getline(in, line);)
+      lines.push_back(std::move(line));
+    it = sourceFiles.emplace(path, std::move(lines)).first;
+  }
+  return it->second.empty() ? nullptr : &it->second;
+}
@@ -0,0 +1,91 @@
+#ifndef DISASSEMBLY_HPP
+#define DISASSEMBLY_HPP
+#include <lldb/API/LLDB.h>
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Disassembled functions, cached by start address for the lifetime of the
+//   target. Code doesn't change between stops, so stepping through a loop
+//   disassembles its function once. Source lines from the line table are
+//   attached to the first instruction of each line
+class Disassembly {
+  public:
+    static constexpr size_t Capacity = 256; // functions
+    // Read at a pc that has no function or symbol around it
+    static constexpr uint32_t FallbackCount = 256;
+    static constexpr uint32_t NoSource = UINT32_MAX;
+    // Marks a source entry in Listing::mixed
+    static constexpr uint32_t SourceFlag = 0x80000000u;
+
+    struct Instruction {
+      lldb::addr_t address;
+      uint32_t size;
+      std::string mnemonic;
+      std::string operands;
+      std::string comment;
+      uint32_t source = NoSource; // the line starting at this instruction
+    };
+    struct SourceLine {
+      std::string file; // filename only
+      uint32_t line;
+      std::string text;
+    };
+    struct Listing {
+      lldb::addr_t start;
+      lldb::addr_t end;
+      std::string name;
+      std::vector<Instruction> instructions;
+      std::vector<SourceLine> sources;
+      // Instruction indices with SourceFlag | source index ahead of the
+      //   instruction each line starts at
+      std::vector<uint32_t> mixed;
+      float ms = 0.f;
+      // Index of the instruction containing address, -1 if none does
+      int32_t Find(lldb::addr_t address) const;
+    };
+    // A frame's pc and the listing around it
+    struct View {
+      uint32_t stop_id;
+      uint32_t thread_index;
+      uint32_t frame_id;
+      lldb::addr_t pc;
+      // Null if nothing could be disassembled at pc
+      std::shared_ptr<const Listing> listing;
+    };
+
+  public:
+    // The listing covering pc, disassembled on a miss. Calls into LLDB, so
+    //   only from the stop queue
+    std::shared_ptr<const Listing> Get(lldb::SBTarget target, lldb::addr_t pc);
+    // Addresses only stay valid for one process
+    void Clear();
+
+    uint64_t GetHits() const;
+    uint64_t GetMisses() const;
+    size_t GetSize();
+
+  private:
+    std::shared_ptr<const Listing> Disassemble(lldb::SBTarget& target, lldb::addr_t pc);
+    const std::vector<std::string>* LoadSource(const std::string& path);
+
+  private:
+    struct Entry {
+      std::shared_ptr<const Listing> listing;
+      uint64_t used;
+    };
+    std::mutex mutex;
+    std::map<lldb::addr_t, Entry> listings; // by start address
+    uint64_t useCounter = 0;
+    std::atomic<uint64_t> hits = 0;
+    std::atomic<uint64_t> misses = 0;
+    // Only touched on the stop queue
+    std::unordered_map<std::string, std::vector<std::string>> sourceFiles;
+};
+
+#endif
@@ -0,0 +1,141 @@
+#include "Exceptions.hpp"
+#include "Logger.hpp"
+#include "Stacks.hpp"
+#include "Trace.hpp"
+#include <algorithm>
+#include <fmt/core.h>
+#if __has_include(<cxxabi.h>)
+#include <cxxabi.h>
+#include <cstdlib>
+#endif
+
+bool Exceptions::Enable(lldb::SBTarget target) {
+  if (breakpointId != LLDB_INVALID_BREAK_ID) return true;
+  lldb::SBBreakpoint bp = target.BreakpointCreateForException(lldb::eLanguageTypeC_plus_plus, false, true);
+  if (!bp.IsValid()) {
+    Logger::Err("Failed to set a C++ throw breakpoint");
+    return false;
+  }
+  bp.SetCallback(&Exceptions::OnThrow, this);
+  breakpointId = bp.GetID();
+  Logger::Info("Counting C++ throws (breakpoint {})", breakpointId);
+  return true;
+}
+
+void Exceptions::Disable(lldb::SBTarget target) {
+  if (breakpointId == LLDB_INVALID_BREAK_ID) return;
+  target.BreakpointDelete(breakpointId);
+  breakpointId = LLDB_INVALID_BREAK_ID;
+}
+
+bool Exceptions::IsEnabled() const {
+  return breakpointId != LLDB_INVALID_BREAK_ID;
+}
+
+uint64_t Exceptions::GetTotalThrows() const {
+  return totalThrows.load(std::memory_order_relaxed);
+}
+
+std::vector<Exceptions::Site> Exceptions::GetSites() {
+  std::vector<Site> sites;
+  {
+    std::lock_guard lock(mutex);
+    sites.reserve(entries.size());
+    for (const auto& [hash, entry] : entries)
+      sites.push_back(Site{hash, entry.throws, entry.type, entry.location, entry.frames});
+  }
+  std::sort(sites.begin(), sites.end(), [](const Site& a, const Site& b) { return a.throws > b.throws; });
+  return sites;
+}
+
+void Exceptions::Clear() {
+  std::lock_guard lock(mutex);
+  entries.clear();
+  totalThrows = 0;
+}
+
+bool Exceptions::OnThrow(void* baton, lldb::SBProcess& process, lldb::SBThread& thread, lldb::SBBreakpointLocation& location) {
+  auto self = static_cast<Exceptions*>(baton);
+  self->totalThrows.fetch_add(1, std::memory_order_relaxed);
+
+  // Frames are unwound one at a time, GetNumFrames() would unwind all of them
+  lldb::addr_t pcs[MaxDepth];
+  uint32_t depth = 0;
+  uint64_t hash = 0xcbf29ce484222325ull;
+  for (; depth < MaxDepth; depth++) {
+    lldb::SBFrame frame = thread.GetFrameAtIndex(depth);
+    if (!frame.IsValid()) break;
+    pcs[depth] = frame.GetPC();
+    hash = (hash ^ pcs[depth]) * 0x100000001b3ull;
+  }
+
+  std::lock_guard lock(self->mutex);
+  auto [begin, end] = self->entries.equal_range(hash);
+  for (auto it = begin; it != end; ++it) {
+    if (std::equal(pcs, pcs + depth, it->second.pcs.begin(), it->second.pcs.end())) {
+      it->second.throws++;
+      return false;
+    }
+  }
+
+  Trace::Scope t("New Throw Site", "exceptions");
+  Entry entry;
+  entry.pcs.assign(pcs, pcs + depth);
+  entry.throws = 1;
+  self->Symbolize(process, thread, entry);
+  self->entries.emplace(hash, std::move(entry));
+
+  // Don't stop
+  return false;
+}
+
+void Exceptions::Symbolize(lldb::SBProcess& process, lldb::SBThread& thread, Entry& entry) {
+  // Frame 0 is the runtime's throw function, stopped at its entry
+  lldb::SBFrame thrower = thread.GetFrameAtIndex(0);
+  const char* thrower_name = thrower.GetFunctionName();
+  if (thrower_name && std::string_view(thrower_name).find("rethrow") != std::string_view::npos)
+    entry.type = "(rethrow)";
+  else
+    entry.type = ReadExceptionType(process, thrower);
+
+  lldb::SBTarget target = process.GetTarget();
+  entry.frames.reserve(entry.pcs.size());
+  for (size_t f = 1; f < entry.pcs.size(); f++)
+    entry.frames.push_back(Stacks::Symbolize(target, entry.pcs[f], false));
+  entry.location = entry.frames.empty() ? "(unknown)" : entry.frames.front();
+}
+
+std::string Exceptions::ReadExceptionType(lldb::SBProcess& process, lldb::SBFrame& frame) {
+  // __cxa_throw(void* object, std::type_info* type, void (*destructor)(void*)),
+  //   the type_info's second word is its mangled name
+  static const char* const TypeRegisters[] = {"rsi", "x1", "r1"};
+  lldb::addr_t type_info = LLDB_INVALID_ADDRESS;
+  for (const char* reg : TypeRegisters) {
+    lldb::SBValue value = frame.FindRegister(reg);
+    if (value.IsValid()) {
+      type_info = value.GetValueAsUnsigned(LLDB_INVALID_ADDRESS);
+      break;
+    }
+  }
+  if (type_info == LLDB_INVALID_ADDRESS || type_info == 0) return "(unknown)";
+
+  lldb::SBError error;
+  lldb::addr_t name_address = process.ReadPointerFromMemory(type_info + process.GetAddressByteSize(), error);
+  if (error.Fail()) return "(unknown)";
+  char name[256] = {};
+  process.ReadCStringFromMemory(name_address, name, sizeof(name), error);
+  if (error.Fail() || !name[0]) return "(unknown)";
+  // Some ABIs mark type names that must be compared by address with a '*'
+  const char* mangled = name[0] == '*' ? name + 1 : name;
+
+#if __has_include(<cxxabi.h>)
+  int status = 0;
+  char* demangled = abi::__cxa_demangle(mangled, nullptr, nullptr, &status);
+  if (status == 0 && demangled) {
+    std::string type = demangled;
+    std::free(demangled);
+    return type;
+  }
+#endif
+  return mangled;
+}
@@ -0,0 +1,57 @@
+#ifndef EXCEPTIONS_HPP
+#define EXCEPTIONS_HPP
+#include <lldb/API/LLDB.h>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Counts C++ throws by where they come from. A throw breakpoint's callback
+//   hashes the backtrace on LLDB's own thread and declines the stop, so the
+//   process keeps running and nothing reaches the event thread or the UI.
+//   Only a backtrace seen for the first time is symbolized
+class Exceptions {
+  public:
+    static constexpr uint32_t MaxDepth = 32;
+
+    struct Site {
+      uint64_t hash;
+      uint64_t throws;
+      std::string type;     // demangled type_info name, when it could be read
+      std::string location; // the frame that threw
+      std::vector<std::string> frames; // leaf first, the runtime's own frame excluded
+    };
+
+  public:
+    bool Enable(lldb::SBTarget target);
+    void Disable(lldb::SBTarget target);
+    bool IsEnabled() const;
+    // Sorted by throws, most first
+    std::vector<Site> GetSites();
+    uint64_t GetTotalThrows() const;
+    void Clear();
+
+  private:
+    struct Entry {
+      std::vector<lldb::addr_t> pcs;
+      uint64_t throws = 0;
+      std::string type;
+      std::string location;
+      std::vector<std::string> frames;
+    };
+
+  private:
+    static bool OnThrow(void* baton, lldb::SBProcess& process, lldb::SBThread& thread, lldb::SBBreakpointLocation& location);
+    static std::string ReadExceptionType(lldb::SBProcess& process, lldb::SBFrame& frame);
+    void Symbolize(lldb::SBProcess& process, lldb::SBThread& thread, Entry& entry);
+
+  private:
+    lldb::break_id_t breakpointId = LLDB_INVALID_BREAK_ID;
+    std::atomic<uint64_t> totalThrows = 0;
+    std::mutex mutex;
+    // Keyed by backtrace hash, the PCs are compared to rule out a collision
+    std::unordered_multimap<uint64_t, Entry> entries;
+};
+
+#endif
@@ -7,6 +7,8 @@
 struct Line {
   std::string line;
   bool bp;
+  // Has a condition or ignore count, drawn differently in the gutter
+  bool bp_conditional = false;
   lldb::break_id_t bp_id = LLDB_INVALID_BREAK_ID;
 };
 
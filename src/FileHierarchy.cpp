@@ -1,6 +1,7 @@
 #include "FileHierarchy.hpp"
 #include "Logger.hpp"
 #include "Util.hpp"
+#include "Trace.hpp"
 #include <iostream>
 #include <fstream>
 #if defined(_WIN32)
@@ -103,6 +104,7 @@ void FileHierarchy::TreeNode::Print(int depth) const {
 
 bool FileHierarchy::TreeNode::LoadFromDisk() {
   Logger::ScopedGroup g("TreeNode::LoadFromDisk");
+  Trace::Scope t("LoadFromDisk", "io");
   if (!lines.has_value()) {
     lines = std::vector<Line>{};
     if (Util::ReadFileLinesIntoVector(path, lines.value())) {
@@ -179,6 +181,9 @@ FileHierarchy::TreeNodeType FileHierarchy::GetOSPathType(const std::filesystem::
 }
 
 void FileHierarchy::AddFile(const std::filesystem::path& path) {
+  // Modules loaded later in the process lifetime often share sources with ones
+  //   already indexed (headers, the main executable reloaded at launch, ...)
+  if (!known_paths.insert(path.string()).second) return;
   paths.push_back(path);
   Logger::Info("Added '{}'", path.string());
 }
@@ -217,12 +222,21 @@ std::vector<std::string> PathToParts(const std::filesystem::path &path)
 
 void FileHierarchy::ComputeTree()
 {
-  for (const auto &path : paths)
+  // Only insert the paths added since the last call, so incrementally loaded
+  //   modules don't rebuild the whole tree
+  if (computed_paths == paths.size()) return;
+  for (size_t i = computed_paths; i < paths.size(); i++)
   {
-    std::vector<std::string> parts = PathToParts(path);
+    std::vector<std::string> parts = PathToParts(paths[i]);
     root.Insert(parts);
   }
-  root.Print();
+  Logger::Info("Inserted {} paths into the hierarchy", paths.size() - computed_paths);
+  computed_paths = paths.size();
+  version++;
+}
+
+uint64_t FileHierarchy::GetVersion() const {
+  return version;
 }
 
 FileHierarchy::TreeNode* FileHierarchy::GetElementByFilenameRec(TreeNode& node, const std::string& filename) const {
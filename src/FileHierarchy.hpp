@@ -1,7 +1,9 @@
 #ifndef FILE_HEIRARCHY_HPP
 #define FILE_HEIRARCHY_HPP
+#include <cstdint>
 #include <map>
 #include <string>
+#include <unordered_set>
 #include <filesystem>
 #include <optional>
 #include <vector>
@@ -28,6 +30,7 @@ class FileHierarchy {
       std::optional<std::vector<Line>> lines;
       std::map<std::string, TreeNode> children;
       bool shouldSwitch;
+      bool open = false;
 
       std::filesystem::path GetPath() const;
 
@@ -51,6 +54,7 @@ class FileHierarchy {
     TreeNode* GetElementByFilename(const std::string& filename);
     TreeNode* GetElementByLocalPath(const std::filesystem::path& localpath);
     void ComputeTree();
+    uint64_t GetVersion() const;
 
   private:
     TreeNode* GetElementByFilenameRec(TreeNode& node, const std::string& filename) const;
@@ -58,7 +62,10 @@ class FileHierarchy {
 
   private:
     std::vector<std::filesystem::path> paths;
+    std::unordered_set<std::string> known_paths;
+    size_t computed_paths = 0;
     TreeNode root;
+    uint64_t version = 0;
 };
 
 #endif
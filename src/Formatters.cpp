@@ -0,0 +1,219 @@
+#include "Formatters.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <string_view>
+#include <fmt/core.h>
+
+namespace {
+  std::array<std::atomic<bool>, (size_t)Formatters::Kind::Count> enabled = {true, true, true, true, true, true, true};
+
+  // First of the member paths that exists, they differ between libstdc++,
+  //   libc++ and MSVC
+  lldb::SBValue FindMember(lldb::SBValue& raw, std::initializer_list<const char*> paths) {
+    for (const char* path : paths) {
+      lldb::SBValue member = raw.GetValueForExpressionPath(path);
+      if (member.IsValid()) return member;
+    }
+    return lldb::SBValue();
+  }
+
+  std::string Quote(std::string_view text, bool truncated) {
+    std::string quoted = "\"";
+    for (char c : text) {
+      switch (c) {
+        case '"': quoted += "\\\""; break;
+        case '\\': quoted += "\\\\"; break;
+        case '\n': quoted += "\\n"; break;
+        case '\t': quoted += "\\t"; break;
+        default: quoted += c; break;
+      }
+    }
+    quoted += truncated ? "\"..." : "\"";
+    return quoted;
+  }
+}
+
+const char* Formatters::GetName(Kind kind) {
+  switch (kind) {
+    case Kind::Vector: return "std::vector";
+    case Kind::String: return "std::string";
+    case Kind::Map: return "std::map";
+    case Kind::UnorderedMap: return "std::unordered_map";
+    case Kind::Optional: return "std::optional";
+    case Kind::UniquePtr: return "std::unique_ptr";
+    case Kind::SharedPtr: return "std::shared_ptr";
+    case Kind::Count: break;
+  }
+  return "?";
+}
+
+bool Formatters::IsEnabled(Kind kind) {
+  return enabled[(size_t)kind].load(std::memory_order_relaxed);
+}
+
+void Formatters::SetEnabled(Kind kind, bool on) {
+  enabled[(size_t)kind] = on;
+}
+
+void Formatters::SetAllEnabled(bool on) {
+  for (auto& flag : enabled)
+    flag = on;
+}
+
+std::optional<Formatters::Kind> Formatters::Classify(lldb::SBValue value) {
+  const char* type_name = value.GetType().GetCanonicalType().GetName();
+  if (!type_name) return std::nullopt;
+  std::string_view name(type_name);
+  if (!name.starts_with("std::")) return std::nullopt;
+  name.remove_prefix(5);
+  // Inline namespaces, std::__1:: (libc++) and std::__cxx11:: (libstdc++)
+  if (name.starts_with("__")) {
+    size_t end = name.find("::");
+    if (end == std::string_view::npos) return std::nullopt;
+    name.remove_prefix(end + 2);
+  }
+
+  std::optional<Kind> kind;
+  if (name.starts_with("vector<") && !name.starts_with("vector<bool")) kind = Kind::Vector;
+  else if (name.starts_with("basic_string<char,") || name.starts_with("basic_string<char >")) kind = Kind::String;
+  else if (name.starts_with("map<")) kind = Kind::Map;
+  else if (name.starts_with("unordered_map<")) kind = Kind::UnorderedMap;
+  else if (name.starts_with("optional<")) kind = Kind::Optional;
+  else if (name.starts_with("unique_ptr<")) kind = Kind::UniquePtr;
+  else if (name.starts_with("shared_ptr<")) kind = Kind::SharedPtr;
+  if (kind && !IsEnabled(*kind)) return std::nullopt;
+  return kind;
+}
+
+std::optional<Formatters::Decoded> Formatters::Decode(Kind kind, lldb::SBValue value) {
+  lldb::SBValue raw = value.GetNonSyntheticValue();
+  switch (kind) {
+    case Kind::Vector: return DecodeVector(raw);
+    case Kind::String: return DecodeString(raw);
+    case Kind::Map:
+    case Kind::UnorderedMap: return DecodeSize(kind, raw);
+    case Kind::Optional: return DecodeOptional(raw);
+    case Kind::UniquePtr:
+    case Kind::SharedPtr: return DecodePointer(kind, value, raw);
+    case Kind::Count: break;
+  }
+  return std::nullopt;
+}
+
+lldb::SBValue Formatters::GetChild(const Decoded& decoded, lldb::SBValue value, uint64_t index) {
+  if (decoded.kind != Kind::Vector)
+    return index == 0 ? decoded.child : lldb::SBValue();
+  lldb::SBType element = decoded.element;
+  return value.CreateValueFromAddress(fmt::format("[{}]", index).c_str(), decoded.first + index * element.GetByteSize(), element);
+}
+
+std::optional<Formatters::Decoded> Formatters::DecodeVector(lldb::SBValue raw) {
+  lldb::SBValue begin = FindMember(raw, {"._M_impl._M_start", ".__begin_", "._Mypair._Myval2._Myfirst"});
+  lldb::SBValue end = FindMember(raw, {"._M_impl._M_finish", ".__end_", "._Mypair._Myval2._Mylast"});
+  if (!begin.IsValid() || !end.IsValid()) return std::nullopt;
+  Decoded decoded{.kind = Kind::Vector};
+  decoded.element = begin.GetType().GetPointeeType();
+  const uint64_t element_size = decoded.element.GetByteSize();
+  const lldb::addr_t first = begin.GetValueAsUnsigned();
+  const lldb::addr_t last = end.GetValueAsUnsigned();
+  if (element_size == 0 || last < first || (last - first) % element_size != 0) return std::nullopt;
+  decoded.first = first;
+  decoded.child_count = (last - first) / element_size;
+  decoded.native_children = true;
+  decoded.summary = fmt::format("size={}", decoded.child_count);
+  return decoded;
+}
+
+std::optional<Formatters::Decoded> Formatters::DecodeString(lldb::SBValue raw) {
+  constexpr uint64_t MaxShown = 256;
+  lldb::addr_t data = LLDB_INVALID_ADDRESS;
+  uint64_t size = 0;
+  if (lldb::SBValue pointer = raw.GetValueForExpressionPath("._M_dataplus._M_p"); pointer.IsValid()) {
+    // libstdc++, the pointer is right even for short strings
+    data = pointer.GetValueAsUnsigned(LLDB_INVALID_ADDRESS);
+    size = raw.GetValueForExpressionPath("._M_string_length").GetValueAsUnsigned();
+  }
+  else if (lldb::SBValue reserved = raw.GetValueForExpressionPath("._Mypair._Myval2._Myres"); reserved.IsValid()) {
+    // MSVC keeps up to 15 chars in place
+    size = raw.GetValueForExpressionPath("._Mypair._Myval2._Mysize").GetValueAsUnsigned();
+    data = reserved.GetValueAsUnsigned() < 16
+      ? raw.GetValueForExpressionPath("._Mypair._Myval2._Bx._Buf").GetLoadAddress()
+      : raw.GetValueForExpressionPath("._Mypair._Myval2._Bx._Ptr").GetValueAsUnsigned(LLDB_INVALID_ADDRESS);
+  }
+  // libc++'s layout depends on its version and ABI flags, LLDB handles it
+  if (data == LLDB_INVALID_ADDRESS) return std::nullopt;
+
+  const uint64_t shown = std::min<uint64_t>(size, MaxShown);
+  std::string text(shown, '\0');
+  if (shown > 0) {
+    lldb::SBError error;
+    lldb::SBProcess process = raw.GetTarget().GetProcess();
+    if (process.ReadMemory(data, text.data(), shown, error) != shown || error.Fail()) return std::nullopt;
+  }
+  return Decoded{.kind = Kind::String, .summary = Quote(text, size > shown)};
+}
+
+std::optional<Formatters::Decoded> Formatters::DecodeSize(Kind kind, lldb::SBValue raw) {
+  lldb::SBValue size = kind == Kind::Map
+    ? FindMember(raw, {"._M_t._M_impl._M_node_count", ".__tree_.__size_", ".__tree_.__pair3_.__value_", "._Mypair._Myval2._Myval2._Mysize"})
+    : FindMember(raw, {"._M_h._M_element_count", ".__table_.__size_", ".__table_.__p2_.__value_", "._List._Mypair._Myval2._Mysize"});
+  if (!size.IsValid()) return std::nullopt;
+  Decoded decoded{.kind = kind};
+  decoded.child_count = size.GetValueAsUnsigned();
+  decoded.summary = fmt::format("size={}", decoded.child_count);
+  return decoded;
+}
+
+std::optional<Formatters::Decoded> Formatters::DecodeOptional(lldb::SBValue raw) {
+  lldb::SBValue engaged = FindMember(raw, {"._M_payload._M_engaged", ".__engaged_", "._Has_value"});
+  if (!engaged.IsValid()) return std::nullopt;
+  Decoded decoded{.kind = Kind::Optional, .native_children = true};
+  if (engaged.GetValueAsUnsigned() == 0) {
+    decoded.summary = "nullopt";
+    return decoded;
+  }
+  decoded.child = FindMember(raw, {"._M_payload._M_payload._M_value", ".__val_", "._Value"});
+  if (!decoded.child.IsValid()) return std::nullopt;
+  decoded.child_count = 1;
+  const char* value = decoded.child.GetValue();
+  decoded.summary = value ? fmt::format("has_value {}", value) : "has_value";
+  return decoded;
+}
+
+std::optional<Formatters::Decoded> Formatters::DecodePointer(Kind kind, lldb::SBValue value, lldb::SBValue raw) {
+  // Every implementation starts with the stored pointer, as long as the
+  //   deleter of a unique_ptr takes no space
+  lldb::SBProcess process = raw.GetTarget().GetProcess();
+  const uint32_t pointer_size = process.GetAddressByteSize();
+  const lldb::addr_t address = raw.GetLoadAddress();
+  lldb::SBType pointee = raw.GetType().GetCanonicalType().GetTemplateArgumentType(0);
+  if (address == LLDB_INVALID_ADDRESS || !pointee.IsValid()) return std::nullopt;
+  if (kind == Kind::UniquePtr && raw.GetByteSize() != pointer_size) return std::nullopt;
+
+  lldb::SBError error;
+  const lldb::addr_t pointer = process.ReadPointerFromMemory(address, error);
+  if (error.Fail()) return std::nullopt;
+  Decoded decoded{.kind = kind, .native_children = true};
+  if (pointer == 0) {
+    decoded.summary = "nullptr";
+    return decoded;
+  }
+  decoded.summary = fmt::format("0x{:x}", pointer);
+  decoded.child = value.CreateValueFromAddress("*", pointer, pointee);
+  decoded.child_count = decoded.child.IsValid() ? 1 : 0;
+
+  if (kind == Kind::SharedPtr) {
+    // The control block follows the pointer, its use count follows its vtable.
+    //   libc++ counts the owners other than the first
+    const lldb::addr_t control = process.ReadPointerFromMemory(address + pointer_size, error);
+    if (!error.Fail() && control != 0) {
+      const bool libcxx = raw.GetChildMemberWithName("__cntrl_").IsValid();
+      const uint32_t count_size = libcxx ? pointer_size : 4;
+      const uint64_t count = process.ReadUnsignedFromMemory(control + pointer_size, count_size, error);
+      if (!error.Fail())
+        decoded.summary += fmt::format(" use_count={}", libcxx ? count + 1 : count);
+    }
+  }
+  return decoded;
+}
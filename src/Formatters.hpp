@@ -0,0 +1,47 @@
+#ifndef FORMATTERS_HPP
+#define FORMATTERS_HPP
+#include <lldb/API/LLDB.h>
+#include <optional>
+#include <string>
+
+// Built-in decoders for common standard library types, used by the Locals
+//   window in place of LLDB's formatters (which can be Python). They read the
+//   raw members and memory directly, picked by the canonical type name.
+//   Each type can be switched back to LLDB's formatter, and a layout that
+//   isn't recognized falls back on its own
+class Formatters {
+  public:
+    enum class Kind { Vector, String, Map, UnorderedMap, Optional, UniquePtr, SharedPtr, Count };
+
+    struct Decoded {
+      Kind kind;
+      std::string summary;
+      uint64_t child_count = 0;
+      // Children are made here rather than by LLDB. Maps only get a summary,
+      //   walking their nodes is left to LLDB
+      bool native_children = false;
+      lldb::addr_t first = LLDB_INVALID_ADDRESS; // vector elements
+      lldb::SBType element;
+      lldb::SBValue child; // optional value or pointee
+    };
+
+  public:
+    static const char* GetName(Kind kind);
+    static bool IsEnabled(Kind kind);
+    static void SetEnabled(Kind kind, bool enabled);
+    static void SetAllEnabled(bool enabled);
+
+    // Kind of value when its formatter is enabled
+    static std::optional<Kind> Classify(lldb::SBValue value);
+    static std::optional<Decoded> Decode(Kind kind, lldb::SBValue value);
+    static lldb::SBValue GetChild(const Decoded& decoded, lldb::SBValue value, uint64_t index);
+
+  private:
+    static std::optional<Decoded> DecodeVector(lldb::SBValue raw);
+    static std::optional<Decoded> DecodeString(lldb::SBValue raw);
+    static std::optional<Decoded> DecodeSize(Kind kind, lldb::SBValue raw);
+    static std::optional<Decoded> DecodeOptional(lldb::SBValue raw);
+    static std::optional<Decoded> DecodePointer(Kind kind, lldb::SBValue value, lldb::SBValue raw);
+};
+
+#endif
@@ -0,0 +1,67 @@
+#include "FrameArena.hpp"
+#include <cstring>
+
+FrameArena::FrameArena(size_t initial_size):
+  buffer(initial_size)
+{
+  arena.emplace(buffer.data(), buffer.size(), &upstream);
+}
+
+void FrameArena::Reset() {
+  last_upstream_allocations = upstream.allocations;
+
+  // Overflowing into upstream blocks means the buffer was too small for the last
+  //   frame, grow it so the steady state doesn't allocate at all
+  if (upstream.allocations > 0) {
+    size_t needed = buffer.size() + upstream.bytes;
+    arena.reset();
+    buffer.resize(needed * 2);
+  }
+  else {
+    arena->release();
+  }
+  if (!arena.has_value())
+    arena.emplace(buffer.data(), buffer.size(), &upstream);
+
+  upstream.allocations = 0;
+  upstream.bytes = 0;
+  bytes_used = 0;
+}
+
+std::pmr::memory_resource* FrameArena::Resource() {
+  return &*arena;
+}
+
+const char* FrameArena::Copy(std::string_view str) {
+  char* copy = static_cast<char*>(arena->allocate(str.size() + 1, alignof(char)));
+  std::memcpy(copy, str.data(), str.size());
+  copy[str.size()] = '\0';
+  bytes_used += str.size() + 1;
+  return copy;
+}
+
+size_t FrameArena::GetBytesUsed() const {
+  return bytes_used;
+}
+
+size_t FrameArena::GetCapacity() const {
+  return buffer.size();
+}
+
+size_t FrameArena::GetUpstreamAllocations() const {
+  return last_upstream_allocations;
+}
+
+void* FrameArena::UpstreamResource::do_allocate(size_t bytes, size_t alignment) {
+  allocations++;
+  this->bytes += bytes;
+  return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+}
+
+void FrameArena::UpstreamResource::do_deallocate(void* p, size_t bytes, size_t alignment) {
+  std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+}
+
+bool FrameArena::UpstreamResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+  return this == &other;
+}
@@ -0,0 +1,53 @@
+#ifndef FRAME_ARENA_HPP
+#define FRAME_ARENA_HPP
+#include <memory_resource>
+#include <optional>
+#include <string_view>
+#include <vector>
+#include <fmt/format.h>
+
+// Monotonic scratch memory for strings that only live for one frame.
+//   Reset() at the start of each frame hands the whole buffer back at once.
+class FrameArena {
+  public:
+    FrameArena(size_t initial_size = 64 * 1024);
+
+    void Reset();
+    std::pmr::memory_resource* Resource();
+
+    // Returns a null terminated copy that stays valid until the next Reset()
+    const char* Copy(std::string_view str);
+
+    template<typename... Args>
+    const char* Format(std::string_view fmt, Args&&... args) {
+      // Inline storage covers labels of typical length without touching the heap
+      fmt::memory_buffer buffer;
+      fmt::vformat_to(std::back_inserter(buffer), fmt, fmt::make_format_args(args...));
+      return Copy(std::string_view(buffer.data(), buffer.size()));
+    }
+
+    size_t GetBytesUsed() const;
+    size_t GetCapacity() const;
+    size_t GetUpstreamAllocations() const;
+
+  private:
+    // Counts the blocks the arena has to request once its buffer runs out
+    class UpstreamResource : public std::pmr::memory_resource {
+      public:
+        size_t allocations = 0;
+        size_t bytes = 0;
+      private:
+        void* do_allocate(size_t bytes, size_t alignment) override;
+        void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+    };
+
+  private:
+    std::vector<std::byte> buffer;
+    UpstreamResource upstream;
+    std::optional<std::pmr::monotonic_buffer_resource> arena;
+    size_t bytes_used = 0;
+    size_t last_upstream_allocations = 0;
+};
+
+#endif
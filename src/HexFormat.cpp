@@ -0,0 +1,72 @@
+#include "HexFormat.hpp"
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HEX_FORMAT_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace HexFormat {
+#ifdef HEX_FORMAT_SSE2
+  namespace {
+    __m128i NibblesToAscii(__m128i nibbles) {
+      const __m128i above_nine = _mm_cmpgt_epi8(nibbles, _mm_set1_epi8(9));
+      const __m128i digits = _mm_add_epi8(nibbles, _mm_set1_epi8('0'));
+      return _mm_add_epi8(digits, _mm_and_si128(above_nine, _mm_set1_epi8('a' - '0' - 10)));
+    }
+
+    void Encode(__m128i v, char* out) {
+      const __m128i low_mask = _mm_set1_epi8(0x0f);
+      const __m128i high = _mm_and_si128(_mm_srli_epi16(v, 4), low_mask);
+      const __m128i low = _mm_and_si128(v, low_mask);
+      // High nibble first for each byte
+      _mm_storeu_si128((__m128i*)out, NibblesToAscii(_mm_unpacklo_epi8(high, low)));
+      _mm_storeu_si128((__m128i*)(out + 16), NibblesToAscii(_mm_unpackhi_epi8(high, low)));
+    }
+  }
+
+  void Bytes16(const uint8_t* in, char* out) {
+    Encode(_mm_loadu_si128((const __m128i*)in), out);
+  }
+
+  void Words16(const uint8_t* in, char* out) {
+    __m128i v = _mm_loadu_si128((const __m128i*)in);
+    // Byte swap each 32 bit lane: bytes within 16 bit halves, then the halves
+    v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+    v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+    v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+    Encode(v, out);
+  }
+
+  void Ascii16(const uint8_t* in, char* out) {
+    const __m128i v = _mm_loadu_si128((const __m128i*)in);
+    // Signed compares, bytes from 0x80 up are negative and so not printable
+    const __m128i printable = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(0x1f)), _mm_cmplt_epi8(v, _mm_set1_epi8(0x7f)));
+    const __m128i text = _mm_or_si128(_mm_and_si128(printable, v), _mm_andnot_si128(printable, _mm_set1_epi8('.')));
+    _mm_storeu_si128((__m128i*)out, text);
+  }
+#else
+  namespace {
+    constexpr char Digits[] = "0123456789abcdef";
+  }
+
+  void Bytes16(const uint8_t* in, char* out) {
+    for (int i = 0; i < 16; i++) {
+      out[i * 2] = Digits[in[i] >> 4];
+      out[i * 2 + 1] = Digits[in[i] & 0xf];
+    }
+  }
+
+  void Words16(const uint8_t* in, char* out) {
+    for (int word = 0; word < 4; word++)
+      for (int i = 0; i < 4; i++) {
+        const uint8_t byte = in[word * 4 + 3 - i];
+        out[word * 8 + i * 2] = Digits[byte >> 4];
+        out[word * 8 + i * 2 + 1] = Digits[byte & 0xf];
+      }
+  }
+
+  void Ascii16(const uint8_t* in, char* out) {
+    for (int i = 0; i < 16; i++)
+      out[i] = in[i] >= 0x20 && in[i] < 0x7f ? (char)in[i] : '.';
+  }
+#endif
+}
@@ -0,0 +1,17 @@
+#ifndef HEX_FORMAT_HPP
+#define HEX_FORMAT_HPP
+#include <cstddef>
+#include <cstdint>
+
+// Text for the memory window's visible rows, 16 bytes at a time with SSE2
+//   where it's available. Outputs aren't null terminated
+namespace HexFormat {
+  // 16 bytes -> 32 hex digits, two per byte in memory order
+  void Bytes16(const uint8_t* in, char* out);
+  // 16 bytes -> 4 little endian words as 8 hex digits each, most significant first
+  void Words16(const uint8_t* in, char* out);
+  // 16 bytes -> 16 chars, '.' for anything that isn't printable ASCII
+  void Ascii16(const uint8_t* in, char* out);
+}
+
+#endif
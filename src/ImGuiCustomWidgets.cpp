@@ -2,7 +2,10 @@
 #include "ImGuiLayer.hpp"
 #include "FileHierarchy.hpp"
 #include "LLDBDebugger.hpp"
+#include "FileContext.hpp"
 #include <imgui.h>
+#include <algorithm>
+#include <cstdio>
 
 namespace ImGuiCustom {
   void Breakpoint(int id, FileHierarchy::TreeNode& node, ImGuiLayer& imguiLayer, bool active) {
@@ -20,6 +23,43 @@ namespace ImGuiCustom {
         debugger.AddBreakpoint(node, id) :
         debugger.RemoveBreakpoint(node, id);
     }
+    // Only one editor can be open at a time, so it edits a shared buffer
+    static LLDBDebugger::BreakpointOptions options;
+    static char condition[256];
+    if (ImGui::IsItemClicked(ImGuiMouseButton_Right)) {
+      const Line& line = node.lines->at(id);
+      options = line.bp ? imguiLayer.GetDebugger().GetBreakpointOptions(line.bp_id) : LLDBDebugger::BreakpointOptions{};
+      snprintf(condition, sizeof(condition), "%s", options.condition.c_str());
+      ImGui::OpenPopup("breakpoint_options");
+    }
+    if (ImGui::BeginPopup("breakpoint_options")) {
+      auto& debugger = imguiLayer.GetDebugger();
+      const bool exists = node.lines->at(id).bp;
+      ImGui::Text("Breakpoint at line %d", id + 1);
+      ImGui::SetNextItemWidth(300);
+      ImGui::InputTextWithHint("##condition", "Condition, e.g. i == 42", condition, sizeof(condition));
+      int ignore_count = (int)options.ignore_count;
+      ImGui::SetNextItemWidth(120);
+      if (ImGui::InputInt("Ignore count", &ignore_count))
+        options.ignore_count = (uint32_t)std::max<int>(ignore_count, 0);
+      ImGui::Checkbox("One shot", &options.one_shot);
+      options.condition = condition;
+      if (ImGui::Button(exists ? "Apply" : "Add")) {
+        if (exists)
+          debugger.SetBreakpointOptions(node, id, options);
+        else
+          debugger.AddBreakpoint(node, id, options);
+        ImGui::CloseCurrentPopup();
+      }
+      if (exists) {
+        ImGui::SameLine();
+        if (ImGui::Button("Remove")) {
+          debugger.RemoveBreakpoint(node, id);
+          ImGui::CloseCurrentPopup();
+        }
+      }
+      ImGui::EndPopup();
+    }
 
     // Get draw list and draw circle
     ImDrawList* drawList = ImGui::GetWindowDrawList();
@@ -33,7 +73,10 @@ namespace ImGuiCustom {
 
     // If checked, draw filled circle
     if (node.lines->at(id).bp) {
-      drawList->AddCircleFilled(center, radius - 2.0f, circle_color, 16);
+      auto fill_color = node.lines->at(id).bp_conditional ?
+        IM_COL32(255, 160, 0, 255) :
+        circle_color;
+      drawList->AddCircleFilled(center, radius - 2.0f, fill_color, 16);
     }
   }
 }
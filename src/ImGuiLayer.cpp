@@ -16,6 +16,12 @@
 #include "Logger.hpp"
 #include "Resources.hpp"
 #include "Styling.hpp"
+#include "AllocationCounter.hpp"
+#include "Profiler.hpp"
+#include "ProcFS.hpp"
+#include "Trace.hpp"
+#include "StopLatency.hpp"
+#include "HexFormat.hpp"
 
 ImGuiLayer::ImGuiLayer(LLDBDebugger& debugger):
   debugger(debugger)
@@ -24,6 +30,12 @@ ImGuiLayer::~ImGuiLayer() {}
 
 void ImGuiLayer::Begin(Window* window) {
   window_ref = window;
+
+  auto allocations = AllocationCounter::GetThreadAllocations();
+  lastFrameAllocations = allocations - frameAllocationsStart;
+  frameAllocationsStart = allocations;
+  frameArena.Reset();
+
   ImGui_ImplGlfw_NewFrame();
   ImGui_ImplOpenGL3_NewFrame();
 
@@ -36,6 +48,7 @@ void ImGuiLayer::Begin(Window* window) {
 void ImGuiLayer::End() {
   ImGui::Render();
   ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+  Profiler::EndFrame(ImGui::GetIO().DeltaTime * 1000.f);
 }
 void ImGuiLayer::BeginDockspace() {
   static bool opt_fullscreen = true;
@@ -70,6 +83,36 @@ void ImGuiLayer::BeginDockspace() {
   if (opt_fullscreen) {
     ImGui::PopStyleVar(2);
   }
+  if (ImGui::BeginMenuBar()) {
+    if (ImGui::BeginMenu("View")) {
+      ImGui::MenuItem("Performance", nullptr, &m_PerformanceWindow_open);
+      ImGui::MenuItem("Sampler", nullptr, &m_SamplerWindow_open);
+      ImGui::MenuItem("Stacks", nullptr, &m_StacksWindow_open);
+      ImGui::MenuItem("Thread Monitor", nullptr, &m_ThreadMonitorWindow_open);
+      ImGui::MenuItem("Resources", nullptr, &m_ResourcesWindow_open);
+      ImGui::MenuItem("Tracepoints", nullptr, &m_TracepointsWindow_open);
+      ImGui::MenuItem("Exceptions", nullptr, &m_ExceptionsWindow_open);
+      ImGui::MenuItem("Signals", nullptr, &m_SignalsWindow_open);
+      ImGui::MenuItem("Watch", nullptr, &m_WatchWindow_open);
+      ImGui::MenuItem("Memory", nullptr, &m_MemoryWindow_open);
+      ImGui::MenuItem("Disassembly", nullptr, &m_DisassemblyWindow_open);
+      ImGui::MenuItem("Registers", nullptr, &m_RegistersWindow_open);
+      ImGui::EndMenu();
+    }
+    if (ImGui::BeginMenu("Trace")) {
+      bool recording = Trace::IsEnabled();
+      if (ImGui::MenuItem("Record", nullptr, &recording))
+        Trace::SetEnabled(recording);
+      if (ImGui::MenuItem("Save Trace...")) {
+        const char* patterns[] = { "*.json" };
+        if (const char* path = tinyfd_saveFileDialog("Save Trace", "trace.json", 1, patterns, "Chrome Trace")) {
+          Trace::Dump(path);
+        }
+      }
+      ImGui::EndMenu();
+    }
+    ImGui::EndMenuBar();
+  }
   ImGuiIO& io = ImGui::GetIO();
   if (io.ConfigFlags & ImGuiConfigFlags_DockingEnable) {
     ImGuiID dockspace_id = ImGui::GetID("DockspaceID");
@@ -84,6 +127,8 @@ void ImGuiLayer::EndDockspace() {
   ImGui::End();
 }
 void ImGuiLayer::Draw() {
+  Profiler::Scope p("Draw");
+  ApplyQueuedFiles();
   DrawDebugWindow();
   DrawCodeWindow();
   DrawFileBrowser();
@@ -93,6 +138,19 @@ void ImGuiLayer::Draw() {
   DrawLLDBCommandWindow();
   DrawProcessIOWindow();
   DrawLocalsWindow();
+  DrawPerformanceWindow();
+  DrawSamplerWindow();
+  DrawStacksWindow();
+  DrawThreadMonitorWindow();
+  DrawResourcesWindow();
+  DrawTracepointsWindow();
+  DrawExceptionsWindow();
+  DrawSignalsWindow();
+  DrawArrayWindow();
+  DrawWatchWindow();
+  DrawMemoryWindow();
+  DrawDisassemblyWindow();
+  DrawRegistersWindow();
 }
 
 LLDBDebugger& ImGuiLayer::GetDebugger()
@@ -119,6 +177,9 @@ bool ImGuiLayer::LoadFile(FileHierarchy::TreeNode& node) {
 
 void ImGuiLayer::DrawDebugWindow() {
   ImGui::Begin("Debug");
+  ImGui::Text("Heap allocations last frame: %llu", (unsigned long long)lastFrameAllocations);
+  ImGui::Text("Frame arena: %zu / %zu bytes, %zu overflow blocks",
+    frameArena.GetBytesUsed(), frameArena.GetCapacity(), frameArena.GetUpstreamAllocations());
   // Open File Dialog
   if (ImGui::Button("Open File Dialog")) {
     const char* fdpath = tinyfd_openFileDialog("Choose File", "", 0, NULL, "executables", 0);
@@ -139,18 +200,7 @@ void ImGuiLayer::DrawDebugWindow() {
         source_directory = path.root_path();
       }
 
-      for (size_t i = 0; i < target.GetNumModules(); i++) {
-        lldb::SBModule mod = target.GetModuleAtIndex(i);
-        for (size_t j = 0; j < mod.GetNumCompileUnits(); j++) {
-          lldb::SBCompileUnit cu = mod.GetCompileUnitAtIndex(j);
-          auto directory_c_str = cu.GetFileSpec().GetDirectory();
-          auto directory = std::filesystem::path(directory_c_str);
-          auto name = cu.GetFileSpec().GetFilename();
-
-          fh.AddFile(directory / name);
-        }
-      }
-      fh.ComputeTree();
+      debugger.IndexTarget(target);
 
       Util::PrintTargetModules(target);
       Util::PrintModuleCompileUnits(target, 0);
@@ -179,18 +229,7 @@ void ImGuiLayer::DrawDebugWindow() {
       source_directory = t_path.root_path();
     }
 
-    for (size_t i = 0; i < target.GetNumModules(); i++) {
-      lldb::SBModule mod = target.GetModuleAtIndex(i);
-      for (size_t j = 0; j < mod.GetNumCompileUnits(); j++) {
-        lldb::SBCompileUnit cu = mod.GetCompileUnitAtIndex(j);
-        auto directory_c_str = cu.GetFileSpec().GetDirectory();
-        auto directory = std::filesystem::path(directory_c_str);
-        auto name = cu.GetFileSpec().GetFilename();
-        if (name)
-          fh.AddFile(directory / name);
-      }
-    }
-    fh.ComputeTree();
+    debugger.IndexTarget(target);
 
     Util::PrintTargetModules(target);
     Util::PrintModuleCompileUnits(target, 0);
@@ -203,8 +242,7 @@ void ImGuiLayer::DrawDebugWindow() {
 void ImGuiLayer::DrawCodeFile(FileHierarchy::TreeNode& node) {
   using namespace lldb_frontend;
   const auto& lldbStyle = Styling::GetStyle();
-  auto node_path_string = node.path.string();
-  bool active_file = debugger.IsActiveFile(node_path_string.c_str());
+  bool active_file = debugger.IsActiveFile(node.path);
   if (node.lines->empty()) return;
   for (int i = 0; i < node.lines->size(); i++) {
     auto& line = node.lines->at(i);
@@ -229,15 +267,15 @@ void ImGuiLayer::DrawCodeFile(FileHierarchy::TreeNode& node) {
 }
 
 void ImGuiLayer::DrawCodeWindow() {
+  Profiler::Scope p("Code");
   ImGui::Begin("Code Window");
   ImGuiTabBarFlags tab_bar_flags = ImGuiTabBarFlags_Reorderable;
   if (ImGui::BeginTabBar("Code File Tabs", tab_bar_flags)) {
     for (auto& file : openFiles) {
-      auto local_path_string = file->name;
       ImGuiTabItemFlags tab_item_flags = file->shouldSwitch ? ImGuiTabItemFlags_SetSelected : ImGuiTabItemFlags_None;
       if (file->shouldSwitch) Logger::Info("Switching to file: {}", file->path.string());
       file->shouldSwitch = false;
-      if (ImGui::BeginTabItem(local_path_string.c_str(), nullptr, tab_item_flags)) {
+      if (ImGui::BeginTabItem(file->name.c_str(), nullptr, tab_item_flags)) {
         DrawCodeFile(*file);
         ImGui::EndTabItem();
       }
@@ -248,13 +286,17 @@ void ImGuiLayer::DrawCodeWindow() {
 }
 
 void ImGuiLayer::DrawThreadWindow() {
+  Profiler::Scope p("Threads");
   ImGui::Begin("Threads");
-  for (int i = 0; i < debugger.GetProcess().GetNumThreads(); i++) {
-    auto thread = debugger.GetProcess().GetThreadAtIndex(i);
+  auto process = debugger.GetProcess();
+  uint32_t thread_count = process.GetNumThreads();
+  for (uint32_t i = 0; i < thread_count; i++) {
+    auto thread = process.GetThreadAtIndex(i);
     if (thread.IsValid()) {
-      std::string formatted = fmt::format("{}", thread.GetIndexID());
-      if (ImGui::TreeNodeEx(formatted.c_str())) {
-        for (int i = 0; i < thread.GetNumFrames(); i++) {
+      auto index_id = thread.GetIndexID();
+      if (ImGui::TreeNodeEx((void*)(intptr_t)index_id, ImGuiTreeNodeFlags_None, "%u", index_id)) {
+        uint32_t frame_count = thread.GetNumFrames();
+        for (uint32_t i = 0; i < frame_count; i++) {
           auto frame = thread.GetFrameAtIndex(i);
           if (frame.IsValid()) {
             ImGui::Text("%d | %s", frame.GetFrameID(), frame.GetDisplayFunctionName());
@@ -267,43 +309,59 @@ void ImGuiLayer::DrawThreadWindow() {
   ImGui::End();
 }
 
-void ImGuiLayer::DrawLocal(lldb::SBValue& val, const std::string& prefix) {
-  const char* name = val.GetName();
-  const char* value = val.GetValue();
-  const char* summary = val.GetSummary();
-  const char* type = val.GetTypeName();
-
-  std::string label = prefix;
-  if (name) label += name;
-
-  std::string val_str;
-  if (value) val_str = value;
-  else if (summary) val_str = summary;
-  else val_str = "<no value>";
-
-  std::string fmt = fmt::format("{} ({}) = {}", label, type ? type : "?", val_str);
-  ImGuiTreeNodeFlags flags = val.GetNumChildren() == 0 ? ImGuiTreeNodeFlags_Leaf : ImGuiTreeNodeFlags_None;
-  if (ImGui::TreeNodeEx(fmt.c_str(), flags)) {
-    for (uint32_t i = 0; i < val.GetNumChildren(); ++i) {
-      auto child = val.GetChildAtIndex(i);
-      if (child.IsValid()) {
-        DrawLocal(child, label + ".");
-      }
-    }
-    ImGui::TreePop();
+void ImGuiLayer::DrawLocal(uint32_t index) {
+  auto& node = localsTree.GetNode(index);
+  ImGuiTreeNodeFlags flags = node.might_have_children ? ImGuiTreeNodeFlags_None : ImGuiTreeNodeFlags_Leaf;
+  const bool changed = valueChanges && valueChanges->Contains(node.path_hash);
+  if (changed) ImGui::PushStyleColor(ImGuiCol_Text, IM_COL32(255, 200, 50, 255));
+  // Keyed by name so a node stays open when its value changes between stops
+  const bool open = ImGui::TreeNodeEx(node.name.c_str(), flags, "%s", node.label.c_str());
+  if (changed) ImGui::PopStyleColor();
+  if (!open) return;
+  if (node.might_have_children && !node.fetched)
+    localsTree.FetchPage(index);
+  if (const auto& array = localsTree.GetNode(index).array; array && array->count > 0) {
+    const char* view = frameArena.Format("View {} x {} as array", array->count, array->element_type);
+    if (ImGui::SmallButton(view) && arrayView.Read(debugger.GetProcess(), *array, localsTree.GetNode(index).name))
+      m_ArrayWindow_open = true;
   }
+  // Fetching can move the nodes, so they're looked up again from here on
+  for (size_t i = 0; i < localsTree.GetNode(index).children.size(); i++)
+    DrawLocal(localsTree.GetNode(index).children[i]);
+  const auto& fetched = localsTree.GetNode(index);
+  if (fetched.has_more) {
+    const char* more = frameArena.Format("Load {} more ({} shown)", VariableTree::PageSize, fetched.children.size());
+    if (ImGui::SmallButton(more))
+      localsTree.FetchPage(index);
+  }
+  ImGui::TreePop();
 }
 
 void ImGuiLayer::DrawLocalsWindow() {
+  Profiler::Scope p("Locals");
   ImGui::Begin("Locals");
-  auto currentThread = debugger.GetProcess().GetSelectedThread();
-  auto currentFrame = currentThread.GetSelectedFrame();
-  auto block = currentFrame.GetFrameBlock();
-  auto variables = block.GetVariables(currentFrame, false, true, false, lldb::DynamicValueType::eNoDynamicValues);
-  for (int i = 0; i < variables.GetSize(); i++) {
-    auto var = variables.GetValueAtIndex(i);
-    DrawLocal(var);
+  if (ImGui::CollapsingHeader("Formatters")) {
+    ImGui::TextDisabled("Unchecked types use LLDB's formatters");
+    for (int i = 0; i < (int)Formatters::Kind::Count; i++) {
+      auto kind = (Formatters::Kind)i;
+      bool enabled = Formatters::IsEnabled(kind);
+      if (ImGui::Checkbox(Formatters::GetName(kind), &enabled)) {
+        Formatters::SetEnabled(kind, enabled);
+        localsTree.Invalidate();
+      }
+    }
   }
+  localsTree.Update(debugger.GetProcess());
+  // Held for the frame, the diff itself is made on the stop queue. Changes
+  //   for another stop or function call than the one shown are dropped
+  valueChanges = debugger.GetValueChanges();
+  if (valueChanges && (valueChanges->stop_id != localsTree.GetStopId() || valueChanges->frame_key != localsTree.GetFrameKey()))
+    valueChanges.reset();
+  if (valueChanges)
+    ImGui::TextDisabled("%zu changed of %zu compared (%.2f ms snapshot, %.3f ms diff)",
+      valueChanges->changed.size(), valueChanges->compared, valueChanges->snapshot_ms, valueChanges->diff_ms);
+  for (uint32_t root : localsTree.GetRoots())
+    DrawLocal(root);
   ImGui::End();
 }
 
@@ -363,46 +421,67 @@ void ImGuiLayer::DrawControlsWindow() {
   ImGui::End();
 }
 
-bool ImGuiLayer::ShowHierarchyItem(FileHierarchy::TreeNode& node, const std::filesystem::path& parent_path, const std::filesystem::path& path) {
+void ImGuiLayer::ShowHierarchyItem(const FileBrowserRow& row) {
+  ImGuiTreeNodeFlags flags = ImGuiTreeNodeFlags_NoTreePushOnOpen;
+  if (row.leaf) flags |= ImGuiTreeNodeFlags_Leaf;
+
+  ImGui::SetCursorPosX(ImGui::GetCursorPosX() + row.depth * ImGui::GetStyle().IndentSpacing);
+  if (row.texture) {
+    auto v = row.texture->GetTextureId();
+    ImGui::ImageWithBg((ImTextureID)(intptr_t)v, row.texture->GetImGuiSizeScaled(0.1f));
+    ImGui::SameLine();
+  }
+
+  // The open state lives on the node so the flattened rows stay authoritative
+  ImGui::SetNextItemOpen(row.node->open, ImGuiCond_Always);
+  ImGui::TreeNodeEx(row.node, flags, "%s", row.label.c_str());
+  if (ImGui::IsItemToggledOpen()) {
+    row.node->open = !row.node->open;
+    fileBrowserRowsDirty = true;
+  }
+  if (row.leaf && ImGui::IsItemClicked(0)) {
+    Logger::Info("Clicked {}", row.node->path.string());
+    row.node->LoadFromDisk();
+    FrontendLoadFile(*row.node);
+  }
+}
+
+void ImGuiLayer::FileHierarchyRecursive(const std::filesystem::path& parent_path, FileHierarchy::TreeNode& node, int depth) {
+  auto [lookahead_path, lookahead_node_ptr] = node.LookaheadPath();
+  auto& lookahead_node = *lookahead_node_ptr;
+
   std::string tex_id;
-  auto type = FileHierarchy::GetTypeFromNode(node);
+  auto type = FileHierarchy::GetTypeFromNode(lookahead_node);
   switch (type) {
     case FileHierarchy::TreeNodeType::FOLDER: tex_id = "folder"; break;
     case FileHierarchy::TreeNodeType::FILE:   tex_id = "file"; break;
     default: tex_id = "unknown"; break;
   }
-  bool isLeaf = type == FileHierarchy::TreeNodeType::FILE;
 
-  ImGuiTreeNodeFlags flags = ImGuiTreeNodeFlags_None;
-  if (isLeaf) flags |= ImGuiTreeNodeFlags_Leaf;
+  fileBrowserRows.push_back(FileBrowserRow{
+    .node = &lookahead_node,
+    .label = lookahead_path.string().substr(parent_path.string().length()),
+    .texture = lldb_frontend::Resources::GetTexture(tex_id),
+    .depth = depth,
+    .leaf = type == FileHierarchy::TreeNodeType::FILE,
+  });
 
-  Texture* tex = nullptr;
-  if (auto tex = lldb_frontend::Resources::GetTexture(tex_id)) {
-    auto v = tex->GetTextureId();
-    ImGui::ImageWithBg((ImTextureID)(intptr_t)v, tex->GetImGuiSizeScaled(0.1f));
-    ImGui::SameLine();
-  }
-  std::string remainder = path.string().substr(parent_path.string().length());
-  bool opened = ImGui::TreeNodeEx(remainder.c_str(), flags);
-  if (isLeaf && ImGui::IsItemClicked(0)) {
-    Logger::Info("Clicked {}", path.string());
-    node.LoadFromDisk();
-    FrontendLoadFile(node);
+  if (lookahead_node.open) {
+    for (auto& [key, child] : lookahead_node.children)
+      FileHierarchyRecursive(lookahead_path, child, depth + 1);
   }
-  return opened;
 }
 
-void ImGuiLayer::FileHierarchyRecursive(const std::filesystem::path& parent_path, FileHierarchy::TreeNode& node) {
-  auto [lookahead_path, lookahead_node_ptr] = node.LookaheadPath();
-  auto& lookahead_node = *lookahead_node_ptr;
-  if (ShowHierarchyItem(lookahead_node, parent_path, lookahead_path)) {
-    for (auto& [key, child] : lookahead_node.children)
-      FileHierarchyRecursive(lookahead_path, child);
-    ImGui::TreePop();
-  }
+void ImGuiLayer::RebuildFileBrowserRows() {
+  fileBrowserRows.clear();
+  for (auto& [key, child] : fh.GetRoot().children)
+    FileHierarchyRecursive(std::filesystem::path(""), child, 0);
+  fileBrowserRowsDirty = false;
+  fileBrowserVersion = fh.GetVersion();
 }
 
 void ImGuiLayer::DrawFileBrowser() {
+  Profiler::Scope p("File Browser");
   ImGui::Begin("File Browser");
 
   auto& root = fh.GetRoot();
@@ -412,27 +491,120 @@ void ImGuiLayer::DrawFileBrowser() {
     return;
   }
 
-  for (auto& [key, child] : root.children)
-    FileHierarchyRecursive(std::filesystem::path(""), child);
+  if (fileBrowserRowsDirty || fileBrowserVersion != fh.GetVersion())
+    RebuildFileBrowserRows();
+
+  // Toggling a row marks the list dirty, the rebuild waits for the next frame
+  //   so the rows being iterated here stay valid.
+  ImGuiListClipper clipper;
+  clipper.Begin((int)fileBrowserRows.size());
+  while (clipper.Step()) {
+    for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++)
+      ShowHierarchyItem(fileBrowserRows[i]);
+  }
+  clipper.End();
 
   ImGui::End();
 }
 
 void ImGuiLayer::DrawBreakpointsWindow() {
+  Profiler::Scope p("Breakpoints");
   ImGui::Begin("Breakpoints");
   auto& dctx = window_ref->GetDebuggerCtx();
-  auto target = dctx.GetTarget();
-  int numBreakpoints = target.GetNumBreakpoints();
-  for (int i = 0; i < numBreakpoints; i++) {
-    auto bp = target.GetBreakpointAtIndex(i);
-    auto id = bp.GetID();
-    auto& b_data = dctx.GetBreakpointData(id);
+  // Gathered once per stop by the debugger, no SB calls from here
+  dctx.RequestBreakpointStats();
+  auto stats = dctx.GetBreakpointStats();
+  for (const auto& b_stats : *stats) {
+    ImGui::PushID(b_stats.id);
+    bool auto_continue = b_stats.auto_continue;
+    if (ImGui::Checkbox("##auto_continue", &auto_continue))
+      dctx.SetBreakpointAutoContinue(b_stats.id, auto_continue);
+    if (ImGui::IsItemHovered())
+      ImGui::SetTooltip("Auto-continue: count hits without stopping");
+    ImGui::SameLine();
+    if (ImGui::Selectable(b_stats.label.c_str()) && !b_stats.path.empty()) {
+      Logger::Info("Navigate to breakpoint at {}", b_stats.path.string());
+        SwitchToCodeFile(b_stats.path);
+    }
+    if (!b_stats.condition.empty()) {
+      ImGui::Indent();
+      ImGui::TextDisabled("if %s", b_stats.condition.c_str());
+      if (b_stats.condition_ms >= 0.f) {
+        // Paid on every hit, including the ones that don't stop
+        ImGui::SameLine();
+        const bool expensive = b_stats.condition_ms > 1.f;
+        if (expensive) ImGui::PushStyleColor(ImGuiCol_Text, IM_COL32(255, 160, 0, 255));
+        ImGui::Text("~%.3f ms/hit", b_stats.condition_ms);
+        if (expensive) ImGui::PopStyleColor();
+        if (ImGui::IsItemHovered())
+          ImGui::SetTooltip("Estimated running time per evaluation while it was the only conditional breakpoint,\nthe program's own work between hits included");
+      }
+      ImGui::Unindent();
+    }
+    if (b_stats.ignore_count > 0 || b_stats.one_shot) {
+      ImGui::Indent();
+      if (b_stats.ignore_count > 0)
+        ImGui::TextDisabled("ignore next %u", b_stats.ignore_count);
+      if (b_stats.one_shot) {
+        if (b_stats.ignore_count > 0) ImGui::SameLine();
+        ImGui::TextDisabled("one shot");
+      }
+      ImGui::Unindent();
+    }
+    ImGui::PopID();
+  }
+
+  ImGui::SeparatorText("Hot locations");
+
+  ImGuiTableFlags table_flags = ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_Sortable | ImGuiTableFlags_Resizable | ImGuiTableFlags_ScrollY;
+  if (ImGui::BeginTable("HotLocations", 5, table_flags)) {
+    ImGui::TableSetupScrollFreeze(0, 1);
+    ImGui::TableSetupColumn("Breakpoint");
+    ImGui::TableSetupColumn("Function", ImGuiTableColumnFlags_WidthStretch);
+    ImGui::TableSetupColumn("Hits", ImGuiTableColumnFlags_DefaultSort | ImGuiTableColumnFlags_PreferSortDescending);
+    ImGui::TableSetupColumn("Hits/s", ImGuiTableColumnFlags_PreferSortDescending);
+    ImGui::TableSetupColumn("Last Hit", ImGuiTableColumnFlags_PreferSortDescending);
+    ImGui::TableHeadersRow();
+
+    ImGuiTableSortSpecs* sort_specs = ImGui::TableGetSortSpecs();
+    const bool rebuild = stats != hotLocationsStats || (sort_specs && sort_specs->SpecsDirty);
+    if (rebuild) {
+      hotLocationsStats = stats;
+      hotLocations.clear();
+      for (const auto& b_stats : *stats)
+        for (const auto& location : b_stats.locations)
+          hotLocations.push_back({&b_stats, &location});
+    }
+    if (rebuild && sort_specs && sort_specs->SpecsCount > 0) {
+      const auto& spec = sort_specs->Specs[0];
+      std::sort(hotLocations.begin(), hotLocations.end(), [&](const HotLocation& a, const HotLocation& b) {
+        int order = 0;
+        switch (spec.ColumnIndex) {
+          case 0: order = a.breakpoint->label.compare(b.breakpoint->label); break;
+          case 1: order = a.location->function.compare(b.location->function); break;
+          case 2: order = (a.location->hits > b.location->hits) - (a.location->hits < b.location->hits); break;
+          case 3: order = (a.location->rate > b.location->rate) - (a.location->rate < b.location->rate); break;
+          case 4: order = (a.location->last_hit > b.location->last_hit) - (a.location->last_hit < b.location->last_hit); break;
+        }
+        return spec.SortDirection == ImGuiSortDirection_Ascending ? order < 0 : order > 0;
+      });
+    }
+    if (sort_specs) sort_specs->SpecsDirty = false;
 
-    std::string label = fmt::format("{}: {}:{}", id, b_data.path.filename().string(), b_data.line_number);
-    if (ImGui::Selectable(label.c_str())) {
-      Logger::Info("Navigate to breakpoint at {}", b_data.path.string());
-        SwitchToCodeFile(b_data.path);
+    const auto now = std::chrono::steady_clock::now();
+    for (const auto& row : hotLocations) {
+      ImGui::TableNextRow();
+      ImGui::TableNextColumn(); ImGui::TextUnformatted(row.breakpoint->label.c_str());
+      ImGui::TableNextColumn(); ImGui::TextUnformatted(row.location->function.c_str());
+      ImGui::TableNextColumn(); ImGui::Text("%u", row.location->hits);
+      ImGui::TableNextColumn(); ImGui::Text("%.1f", row.location->rate);
+      ImGui::TableNextColumn();
+      if (row.location->hits == 0)
+        ImGui::TextDisabled("never");
+      else
+        ImGui::Text("%.1f s ago", std::chrono::duration<float>(now - row.location->last_hit).count());
     }
+    ImGui::EndTable();
   }
   ImGui::End();
 }
@@ -476,6 +648,7 @@ void ImGuiLayer::DrawLLDBCommandWindow() {
 }
 
 void ImGuiLayer::DrawProcessIOWindow() {
+  Profiler::Scope p("Process IO");
   ImGui::Begin("Process IO");
   static char inputBuf[256];
   static ImVector<std::string> items;
@@ -495,6 +668,76 @@ void ImGuiLayer::DrawProcessIOWindow() {
   ImGui::End();
 }
 
+void ImGuiLayer::DrawPerformanceWindow() {
+  // Counting slows every SB call down, so only while it's looked at
+  debugger.SetCountSBCalls(m_PerformanceWindow_open && performanceCountSBCalls);
+  if (!m_PerformanceWindow_open) return;
+  if (!ImGui::Begin("Performance", &m_PerformanceWindow_open)) {
+    ImGui::End();
+    return;
+  }
+
+  const auto& frame_times = Profiler::GetFrameTimes();
+  ImGui::Text("Frame: %.2f ms | p50 %.2f ms | p99 %.2f ms",
+    frame_times.Empty() ? 0.f : frame_times.Back(),
+    frame_times.Percentile(0.5f),
+    frame_times.Percentile(0.99f));
+  ImGui::PlotLines("##frame_times", frame_times.Data(), (int)frame_times.Size(), (int)frame_times.GetOffset(),
+    nullptr, 0.f, FLT_MAX, ImVec2(ImGui::GetContentRegionAvail().x, 60.f));
+
+  ImGui::Checkbox("Count SB calls", &performanceCountSBCalls);
+  if (ImGui::IsItemHovered())
+    ImGui::SetTooltip("Counted from LLDB's api log, which adds its own cost to the timings");
+  if (performanceCountSBCalls) {
+    const auto& sb_calls = Profiler::GetFrameSBCalls();
+    ImGui::SameLine();
+    ImGui::Text("%.0f per frame | p50 %.0f | p99 %.0f",
+      sb_calls.Empty() ? 0.f : sb_calls.Back(),
+      sb_calls.Percentile(0.5f),
+      sb_calls.Percentile(0.99f));
+  }
+
+  ImGuiTableFlags table_flags = ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_SizingFixedFit;
+  if (ImGui::BeginTable("Sections", 6, table_flags)) {
+    ImGui::TableSetupColumn("Section");
+    ImGui::TableSetupColumn("Last (ms)");
+    ImGui::TableSetupColumn("p50 (ms)");
+    ImGui::TableSetupColumn("p99 (ms)");
+    ImGui::TableSetupColumn("SB calls");
+    ImGui::TableSetupColumn("History", ImGuiTableColumnFlags_WidthStretch);
+    ImGui::TableHeadersRow();
+    for (const auto& section : Profiler::GetSections()) {
+      ImGui::TableNextRow();
+      ImGui::TableNextColumn(); ImGui::TextUnformatted(section.name);
+      ImGui::TableNextColumn(); ImGui::Text("%.3f", section.times_ms.Empty() ? 0.f : section.times_ms.Back());
+      ImGui::TableNextColumn(); ImGui::Text("%.3f", section.times_ms.Percentile(0.5f));
+      ImGui::TableNextColumn(); ImGui::Text("%.3f", section.times_ms.Percentile(0.99f));
+      ImGui::TableNextColumn();
+      if (performanceCountSBCalls) ImGui::Text("%.0f", section.sb_calls.Empty() ? 0.f : section.sb_calls.Back());
+      else ImGui::TextDisabled("-");
+      ImGui::TableNextColumn();
+      ImGui::PushID(section.name);
+      ImGui::PlotLines("##history", section.times_ms.Data(), (int)section.times_ms.Size(), (int)section.times_ms.GetOffset(),
+        nullptr, 0.f, FLT_MAX, ImVec2(-1.f, ImGui::GetTextLineHeight()));
+      ImGui::PopID();
+    }
+    ImGui::EndTable();
+  }
+
+  ImGui::SeparatorText("Stop latency");
+  auto hand_off = StopLatency::GetHandOffHistory();
+  auto present = StopLatency::GetPresentHistory();
+  ImGui::Text("Stops: %llu", (unsigned long long)StopLatency::GetHandedOffCount());
+  ImGui::Text("Stop -> hand off: p50 %.2f ms | p99 %.2f ms", hand_off.Percentile(0.5f), hand_off.Percentile(0.99f));
+  ImGui::PlotHistogram("##hand_off", hand_off.Data(), (int)hand_off.Size(), (int)hand_off.GetOffset(),
+    nullptr, 0.f, FLT_MAX, ImVec2(ImGui::GetContentRegionAvail().x, 40.f));
+  ImGui::Text("Stop -> present: p50 %.2f ms | p99 %.2f ms", present.Percentile(0.5f), present.Percentile(0.99f));
+  ImGui::PlotHistogram("##present", present.Data(), (int)present.Size(), (int)present.GetOffset(),
+    nullptr, 0.f, FLT_MAX, ImVec2(ImGui::GetContentRegionAvail().x, 40.f));
+
+  ImGui::End();
+}
+
 void ImGuiLayer::DrawFilesNotFoundModal()
 {
   if (m_FilesNotFoundModal_open)
@@ -542,6 +785,23 @@ void ImGuiLayer::PushIOLine(const std::string& line) {
   processIOWindowItems.push_back(line);
 }
 
+void ImGuiLayer::QueueFiles(const std::vector<std::filesystem::path>& paths) {
+  std::lock_guard lock(queuedFilesMutex);
+  queuedFiles.insert(queuedFiles.end(), paths.begin(), paths.end());
+}
+
+void ImGuiLayer::ApplyQueuedFiles() {
+  std::vector<std::filesystem::path> paths;
+  {
+    std::lock_guard lock(queuedFilesMutex);
+    if (queuedFiles.empty()) return;
+    paths.swap(queuedFiles);
+  }
+  for (const auto& path : paths)
+    fh.AddFile(path);
+  fh.ComputeTree();
+}
+
 bool ImGuiLayer::FrontendLoadFile(FileHierarchy::TreeNode& node) {
   if (LoadFile(node)) {
     if (std::find(openFiles.begin(), openFiles.end(), &node) == openFiles.end()) {
@@ -574,3 +834,1071 @@ void ImGuiLayer::SwitchToCodeFile(const std::filesystem::path& path) {
   // tb->NextSelectedTabId = tab_id;
 }
 
+
+void ImGuiLayer::DrawSamplerWindow() {
+  if (!m_SamplerWindow_open) return;
+  if (!ImGui::Begin("Sampler", &m_SamplerWindow_open)) {
+    ImGui::End();
+    return;
+  }
+
+  Sampler& sampler = debugger.GetSampler();
+  auto process = debugger.GetProcess();
+  if (ImGui::SliderInt("Rate (Hz)", &samplerRate, Sampler::MinRate, Sampler::MaxRate))
+    sampler.SetRate(samplerRate);
+  if (sampler.IsRunning()) {
+    if (ImGui::Button("Stop Sampling"))
+      sampler.Stop();
+  }
+  else {
+    ImGui::BeginDisabled(!process.IsValid());
+    if (ImGui::Button("Start Sampling"))
+      sampler.Start(process, samplerRate);
+    ImGui::EndDisabled();
+  }
+
+  auto stats = sampler.GetStats();
+  ImGui::Text("Samples: %llu | Stacks: %llu | Symbols: %llu",
+    (unsigned long long)stats.samples, (unsigned long long)stats.stacks, (unsigned long long)stats.symbols);
+  ImGui::Text("Pause per sample: p50 %.3f ms | p99 %.3f ms", stats.pause_ms.Percentile(0.5f), stats.pause_ms.Percentile(0.99f));
+  ImGui::Text("Interrupt latency: p50 %.3f ms | p99 %.3f ms", stats.interrupt_ms.Percentile(0.5f), stats.interrupt_ms.Percentile(0.99f));
+  ImGui::PlotLines("##pause", stats.pause_ms.Data(), (int)stats.pause_ms.Size(), (int)stats.pause_ms.GetOffset(),
+    nullptr, 0.f, FLT_MAX, ImVec2(ImGui::GetContentRegionAvail().x, 40.f));
+
+  auto profile = sampler.GetProfile();
+  if (!profile || profile->nodes[0].total == 0) {
+    ImGui::TextDisabled("No samples yet");
+    ImGui::End();
+    return;
+  }
+
+  if (ImGui::BeginTabBar("SamplerViews")) {
+    if (ImGui::BeginTabItem("Call Tree")) {
+      ImGuiTableFlags table_flags = ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersV | ImGuiTableFlags_ScrollY | ImGuiTableFlags_Resizable;
+      if (ImGui::BeginTable("CallTree", 3, table_flags)) {
+        ImGui::TableSetupScrollFreeze(0, 1);
+        ImGui::TableSetupColumn("Function", ImGuiTableColumnFlags_WidthStretch);
+        ImGui::TableSetupColumn("Total", ImGuiTableColumnFlags_WidthFixed, 80.f);
+        ImGui::TableSetupColumn("Self", ImGuiTableColumnFlags_WidthFixed, 80.f);
+        ImGui::TableHeadersRow();
+        DrawCallTreeNode(*profile, 0);
+        ImGui::EndTable();
+      }
+      ImGui::EndTabItem();
+    }
+    if (ImGui::BeginTabItem("Flame Graph")) {
+      DrawFlameGraph(*profile);
+      ImGui::EndTabItem();
+    }
+    ImGui::EndTabBar();
+  }
+
+  ImGui::End();
+}
+
+void ImGuiLayer::DrawCallTreeNode(const Sampler::Profile& profile, uint32_t index) {
+  const auto& node = profile.nodes[index];
+  const float root_total = (float)profile.nodes[0].total;
+  ImGui::TableNextRow();
+  ImGui::TableNextColumn();
+  ImGuiTreeNodeFlags flags = ImGuiTreeNodeFlags_SpanFullWidth;
+  if (node.children.empty())
+    flags |= ImGuiTreeNodeFlags_Leaf | ImGuiTreeNodeFlags_NoTreePushOnOpen;
+  if (index == 0)
+    flags |= ImGuiTreeNodeFlags_DefaultOpen;
+  bool open = ImGui::TreeNodeEx((void*)(intptr_t)index, flags, "%s", profile.symbols[node.symbol].c_str());
+  ImGui::TableNextColumn(); ImGui::Text("%.1f%%", 100.f * node.total / root_total);
+  ImGui::TableNextColumn(); ImGui::Text("%.1f%%", 100.f * node.self / root_total);
+  if (open && !node.children.empty()) {
+    for (auto child : node.children)
+      DrawCallTreeNode(profile, child);
+    ImGui::TreePop();
+  }
+}
+
+void ImGuiLayer::DrawFlameGraph(const Sampler::Profile& profile) {
+  // Icicle layout: the root spans the full width on top, callees below, each
+  //   frame as wide as its share of the samples
+  const float row_height = ImGui::GetTextLineHeightWithSpacing();
+  const float width = ImGui::GetContentRegionAvail().x;
+  const ImVec2 origin = ImGui::GetCursorScreenPos();
+  ImDrawList* draw_list = ImGui::GetWindowDrawList();
+  const ImVec2 mouse = ImGui::GetMousePos();
+  const float scale = width / (float)profile.nodes[0].total;
+  const Sampler::Node* hovered = nullptr;
+
+  struct Item { uint32_t index; float x; };
+  std::vector<Item> stack = {{0, origin.x}};
+  while (!stack.empty()) {
+    auto [index, x] = stack.back();
+    stack.pop_back();
+    const auto& node = profile.nodes[index];
+    const float w = node.total * scale;
+    const ImVec2 min(x, origin.y + node.depth * row_height);
+    const ImVec2 max(x + w, min.y + row_height - 1.f);
+
+    // Stable colour per function, warm palette
+    uint32_t hash = node.symbol * 2654435761u;
+    ImU32 colour = IM_COL32(205 + (hash & 0x3f), 90 + ((hash >> 8) & 0x7f), 40 + ((hash >> 16) & 0x3f), 255);
+    draw_list->AddRectFilled(min, max, colour);
+    const std::string& name = profile.symbols[node.symbol];
+    if (w > 20.f) {
+      draw_list->PushClipRect(min, max, true);
+      draw_list->AddText(ImVec2(min.x + 3.f, min.y), IM_COL32(0, 0, 0, 255), name.c_str());
+      draw_list->PopClipRect();
+    }
+    if (mouse.x >= min.x && mouse.x < max.x && mouse.y >= min.y && mouse.y < max.y)
+      hovered = &node;
+
+    float child_x = x;
+    for (auto child : node.children) {
+      // Anything under a pixel wide isn't readable, and neither are its callees
+      if (profile.nodes[child].total * scale >= 1.f)
+        stack.push_back({child, child_x});
+      child_x += profile.nodes[child].total * scale;
+    }
+  }
+
+  ImGui::InvisibleButton("##flame_graph", ImVec2(width, (profile.max_depth + 1) * row_height));
+  if (hovered && ImGui::IsItemHovered()) {
+    ImGui::SetTooltip("%s\n%u samples (%.1f%%), %u self",
+      profile.symbols[hovered->symbol].c_str(), hovered->total,
+      100.f * hovered->total / profile.nodes[0].total, hovered->self);
+  }
+}
+
+void ImGuiLayer::DrawStacksWindow() {
+  if (!m_StacksWindow_open) return;
+  if (!ImGui::Begin("Stacks", &m_StacksWindow_open)) {
+    ImGui::End();
+    return;
+  }
+  Profiler::Scope p("Stacks");
+
+  auto process = debugger.GetProcess();
+  auto snapshot = debugger.GetStacks();
+  if (!snapshot) {
+    ImGui::TextDisabled(process.IsValid() ? "Waiting for a stop..." : "No process");
+    ImGui::End();
+    return;
+  }
+  if (snapshot->stop_id != process.GetStopID())
+    ImGui::TextDisabled("Collecting...");
+  ImGui::Text("%zu threads, %zu unique stacks", snapshot->thread_count, snapshot->groups.size());
+  ImGui::Text("Snapshot: %.2f ms unwinding (%zu workers) + %.2f ms grouping",
+    snapshot->collect_ms, snapshot->worker_count, snapshot->group_ms);
+
+  ImGuiTableFlags table_flags = ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersV | ImGuiTableFlags_ScrollY | ImGuiTableFlags_Resizable;
+  if (ImGui::BeginTable("StackGroups", 2, table_flags)) {
+    ImGui::TableSetupScrollFreeze(0, 1);
+    ImGui::TableSetupColumn("Threads", ImGuiTableColumnFlags_WidthFixed, 70.f);
+    ImGui::TableSetupColumn("Stack", ImGuiTableColumnFlags_WidthStretch);
+    ImGui::TableHeadersRow();
+    for (size_t i = 0; i < snapshot->groups.size(); i++) {
+      const auto& group = snapshot->groups[i];
+      ImGui::TableNextRow();
+      ImGui::TableNextColumn();
+      ImGui::Text("%zu", group.thread_ids.size());
+      ImGui::TableNextColumn();
+      const char* top = group.frames.empty() ? "<no frames>" : group.frames[0].label.c_str();
+      if (ImGui::TreeNodeEx((void*)(intptr_t)i, ImGuiTreeNodeFlags_SpanFullWidth, "%s", top)) {
+        ImGui::TextDisabled("Threads: %s", group.threads_label.c_str());
+        for (const auto& frame : group.frames)
+          ImGui::Text("0x%016llx  %s", (unsigned long long)frame.pc, frame.label.c_str());
+        ImGui::TreePop();
+      }
+    }
+    ImGui::EndTable();
+  }
+
+  ImGui::End();
+}
+
+void ImGuiLayer::DrawThreadMonitorWindow() {
+  if (!m_ThreadMonitorWindow_open) return;
+  if (!ImGui::Begin("Thread Monitor", &m_ThreadMonitorWindow_open)) {
+    ImGui::End();
+    return;
+  }
+  Profiler::Scope p("Thread Monitor");
+
+  if (!ProcFS::IsSupported()) {
+    ImGui::TextDisabled("Reads /proc, only available on Linux");
+    ImGui::End();
+    return;
+  }
+
+  ThreadMonitor& monitor = debugger.GetThreadMonitor();
+  auto process = debugger.GetProcess();
+  if (ImGui::SliderInt("Rate (Hz)", &threadMonitorRate, ThreadMonitor::MinRate, ThreadMonitor::MaxRate))
+    monitor.SetRate(threadMonitorRate);
+  if (monitor.IsRunning()) {
+    if (ImGui::Button("Stop Monitor"))
+      monitor.Stop();
+  }
+  else {
+    ImGui::BeginDisabled(!process.IsValid());
+    if (ImGui::Button("Start Monitor"))
+      monitor.Start((int)process.GetProcessID(), threadMonitorRate);
+    ImGui::EndDisabled();
+  }
+
+  auto snapshot = monitor.GetSnapshot();
+  if (!snapshot) {
+    ImGui::End();
+    return;
+  }
+  if (snapshot->ended)
+    ImGui::TextDisabled("Process has exited");
+  const size_t thread_count = snapshot->threads.size();
+  ImGui::Text("%zu threads | CPU %.1f%% | sample %.1f us (%.2f us/thread) | %zu/%zu stat fds cached",
+    thread_count, snapshot->process_cpu, snapshot->sample_us,
+    thread_count ? snapshot->sample_us / thread_count : 0.f, snapshot->cached_files, thread_count);
+
+  ImGuiTableFlags table_flags = ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersV | ImGuiTableFlags_ScrollY | ImGuiTableFlags_Resizable;
+  if (ImGui::BeginTable("MonitoredThreads", 7, table_flags)) {
+    ImGui::TableSetupScrollFreeze(0, 1);
+    ImGui::TableSetupColumn("TID", ImGuiTableColumnFlags_WidthFixed, 60.f);
+    ImGui::TableSetupColumn("Name", ImGuiTableColumnFlags_WidthFixed, 120.f);
+    ImGui::TableSetupColumn("State", ImGuiTableColumnFlags_WidthFixed, 40.f);
+    ImGui::TableSetupColumn("CPU %", ImGuiTableColumnFlags_WidthFixed, 50.f);
+    ImGui::TableSetupColumn("CPU History", ImGuiTableColumnFlags_WidthStretch);
+    ImGui::TableSetupColumn("Waiting In", ImGuiTableColumnFlags_WidthFixed, 140.f);
+    ImGui::TableSetupColumn("Switches (vol/invol)", ImGuiTableColumnFlags_WidthFixed, 130.f);
+    ImGui::TableHeadersRow();
+
+    ImGuiListClipper clipper;
+    clipper.Begin((int)thread_count);
+    while (clipper.Step()) {
+      for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++) {
+        const auto& thread = snapshot->threads[i];
+        ImGui::TableNextRow();
+        ImGui::TableNextColumn(); ImGui::Text("%d", thread.tid);
+        ImGui::TableNextColumn(); ImGui::TextUnformatted(thread.name.c_str());
+        ImGui::TableNextColumn(); ImGui::Text("%c", thread.state);
+        ImGui::TableNextColumn(); ImGui::Text("%.1f", thread.cpu);
+        ImGui::TableNextColumn();
+        ImGui::PushID(thread.tid);
+        ImGui::PlotLines("##cpu", thread.cpu_history.Data(), (int)thread.cpu_history.Size(), (int)thread.cpu_history.GetOffset(),
+          nullptr, 0.f, 100.f, ImVec2(-1.f, ImGui::GetTextLineHeight()));
+        ImGui::PopID();
+        ImGui::TableNextColumn(); ImGui::TextUnformatted(thread.wchan.c_str());
+        ImGui::TableNextColumn();
+        ImGui::Text("%llu / %llu", (unsigned long long)thread.voluntary_switches, (unsigned long long)thread.involuntary_switches);
+      }
+    }
+    clipper.End();
+    ImGui::EndTable();
+  }
+
+  ImGui::End();
+}
+
+void ImGuiLayer::DrawResourcesWindow() {
+  if (!m_ResourcesWindow_open) return;
+  if (!ImGui::Begin("Resources", &m_ResourcesWindow_open)) {
+    ImGui::End();
+    return;
+  }
+  Profiler::Scope p("Resources");
+
+  if (!ProcFS::IsSupported()) {
+    ImGui::TextDisabled("Reads /proc, only available on Linux");
+    ImGui::End();
+    return;
+  }
+
+  auto series = debugger.GetResourceMonitor().GetSeries();
+  if (series.samples == 0) {
+    ImGui::TextDisabled("Sampling starts when the process is launched");
+    ImGui::End();
+    return;
+  }
+
+  // Shade the stretches spent stopped in the debugger behind every plot, so
+  //   growth can be lined up with breakpoints and steps
+  auto plot = [&](const char* label, const ResourceMonitor::History& history, const char* unit) {
+    const float latest = history.Empty() ? 0.f : history.Back();
+    ImGui::Text("%s: %.1f %s", label, latest, unit);
+    ImGui::PushID(label);
+    ImGui::PlotLines("##plot", history.Data(), (int)history.Size(), (int)history.GetOffset(),
+      nullptr, 0.f, FLT_MAX, ImVec2(ImGui::GetContentRegionAvail().x, 50.f));
+    ImGui::PopID();
+    ImVec2 min = ImGui::GetItemRectMin();
+    ImVec2 max = ImGui::GetItemRectMax();
+    const size_t count = series.stopped.Size();
+    if (count < 2) return;
+    const float step = (max.x - min.x) / (float)(count - 1);
+    ImDrawList* draw_list = ImGui::GetWindowDrawList();
+    for (size_t i = 0; i < count; i++) {
+      if (series.stopped[i] == 0.f) continue;
+      size_t end = i;
+      while (end + 1 < count && series.stopped[end + 1] > 0.f) end++;
+      draw_list->AddRectFilled(ImVec2(min.x + i * step, min.y), ImVec2(min.x + end * step + 1.f, max.y), IM_COL32(255, 80, 80, 50));
+      i = end;
+    }
+  };
+
+  plot("RSS", series.rss_mb, "MiB");
+  plot("Data", series.data_mb, "MiB");
+  plot("CPU", series.cpu, "%");
+  plot("Threads", series.threads, "");
+  plot("Open fds", series.fds, "");
+  if (series.io_available) {
+    plot("Read", series.read_kbs, "KiB/s");
+    plot("Write", series.write_kbs, "KiB/s");
+  }
+  else {
+    ImGui::TextDisabled("/proc/<pid>/io is not readable");
+  }
+
+  ImGui::End();
+}
+
+void ImGuiLayer::DrawTracepointsWindow() {
+  if (!m_TracepointsWindow_open) return;
+  if (!ImGui::Begin("Tracepoints", &m_TracepointsWindow_open)) {
+    ImGui::End();
+    return;
+  }
+  Profiler::Scope p("Tracepoints");
+  Tracepoints& tracepoints = debugger.GetTracepoints();
+
+  ImGui::SetNextItemWidth(150.f);
+  ImGui::InputText("##location", &tracepointLocation);
+  ImGui::SameLine();
+  ImGui::SetNextItemWidth(-80.f);
+  bool add = ImGui::InputText("##message", &tracepointMessage, ImGuiInputTextFlags_EnterReturnsTrue);
+  ImGui::SameLine();
+  add |= ImGui::Button("Add");
+  if (add && !tracepointLocation.empty() && !tracepointMessage.empty())
+    debugger.ExecCommand(fmt::format("tp {} {}", tracepointLocation, tracepointMessage), fh);
+  ImGui::TextDisabled("file:line and a message, {var} is replaced with the value of var");
+
+  // Rate over the last half second
+  const double now = ImGui::GetTime();
+  const uint64_t total_hits = tracepoints.GetTotalHits();
+  if (now - tracepointRateTime >= 0.5) {
+    tracepointRate = (float)((total_hits - tracepointRateHits) / (now - tracepointRateTime));
+    tracepointRateHits = total_hits;
+    tracepointRateTime = now;
+  }
+  ImGui::Text("Hits: %llu | %.0f hits/s", (unsigned long long)total_hits, tracepointRate);
+
+  auto infos = tracepoints.GetTracepoints();
+  ImGuiTableFlags table_flags = ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_SizingFixedFit;
+  if (!infos.empty() && ImGui::BeginTable("TracepointList", 5, table_flags)) {
+    ImGui::TableSetupColumn("ID");
+    ImGui::TableSetupColumn("Location");
+    ImGui::TableSetupColumn("Message", ImGuiTableColumnFlags_WidthStretch);
+    ImGui::TableSetupColumn("Hits");
+    ImGui::TableSetupColumn("");
+    ImGui::TableHeadersRow();
+    for (const auto& info : infos) {
+      ImGui::TableNextRow();
+      ImGui::TableNextColumn(); ImGui::Text("%d", info.id);
+      ImGui::TableNextColumn(); ImGui::TextUnformatted(info.location.c_str());
+      ImGui::TableNextColumn(); ImGui::TextUnformatted(info.message.c_str());
+      ImGui::TableNextColumn(); ImGui::Text("%llu", (unsigned long long)info.hits);
+      ImGui::TableNextColumn();
+      ImGui::PushID(info.id);
+      if (ImGui::SmallButton("Remove"))
+        tracepoints.Remove(debugger.GetTarget(), info.id);
+      ImGui::PopID();
+    }
+    ImGui::EndTable();
+  }
+
+  if (ImGui::Button("Clear Log"))
+    tracepoints.ClearLog();
+  ImGui::BeginChild("TraceLog", ImVec2(0, 0), ImGuiChildFlags_Borders);
+  const uint64_t first = tracepoints.GetFirstLogLine();
+  const uint64_t count = tracepoints.GetLogLineCount() - first;
+  const bool at_bottom = ImGui::GetScrollY() >= ImGui::GetScrollMaxY();
+  ImGuiListClipper clipper;
+  clipper.Begin((int)count);
+  while (clipper.Step()) {
+    // Only the visible lines are copied out of the log
+    tracepoints.CopyLogLines(first + clipper.DisplayStart, clipper.DisplayEnd - clipper.DisplayStart, tracepointLogLines);
+    for (const auto& line : tracepointLogLines)
+      ImGui::TextUnformatted(line.c_str());
+  }
+  clipper.End();
+  if (at_bottom)
+    ImGui::SetScrollHereY(1.0f);
+  ImGui::EndChild();
+
+  ImGui::End();
+}
+
+void ImGuiLayer::DrawExceptionsWindow() {
+  if (!m_ExceptionsWindow_open) return;
+  if (!ImGui::Begin("Exceptions", &m_ExceptionsWindow_open)) {
+    ImGui::End();
+    return;
+  }
+  Profiler::Scope p("Exceptions");
+  Exceptions& exceptions = debugger.GetExceptions();
+
+  bool enabled = exceptions.IsEnabled();
+  if (ImGui::Checkbox("Count C++ throws", &enabled)) {
+    if (enabled)
+      exceptions.Enable(debugger.GetTarget());
+    else
+      exceptions.Disable(debugger.GetTarget());
+  }
+  ImGui::SameLine();
+  if (ImGui::Button("Clear"))
+    exceptions.Clear();
+  ImGui::TextDisabled("Throws never stop the process, each one is counted against its backtrace");
+
+  // Rate over the last half second
+  const double now = ImGui::GetTime();
+  const uint64_t total_throws = exceptions.GetTotalThrows();
+  if (now - exceptionRateTime >= 0.5) {
+    exceptionRate = total_throws >= exceptionRateThrows
+      ? (float)((total_throws - exceptionRateThrows) / (now - exceptionRateTime))
+      : 0.f;
+    exceptionRateThrows = total_throws;
+    exceptionRateTime = now;
+  }
+  auto sites = exceptions.GetSites();
+  ImGui::Text("Throws: %llu | %.0f throws/s | %zu sites", (unsigned long long)total_throws, exceptionRate, sites.size());
+
+  ImGuiTableFlags table_flags = ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersV | ImGuiTableFlags_BordersOuter | ImGuiTableFlags_Resizable | ImGuiTableFlags_ScrollY;
+  if (ImGui::BeginTable("ThrowSites", 4, table_flags)) {
+    ImGui::TableSetupScrollFreeze(0, 1);
+    ImGui::TableSetupColumn("Throws", ImGuiTableColumnFlags_WidthFixed);
+    ImGui::TableSetupColumn("%", ImGuiTableColumnFlags_WidthFixed);
+    ImGui::TableSetupColumn("Type");
+    ImGui::TableSetupColumn("Thrown from", ImGuiTableColumnFlags_WidthStretch);
+    ImGui::TableHeadersRow();
+    for (const auto& site : sites) {
+      ImGui::TableNextRow();
+      ImGui::TableNextColumn(); ImGui::Text("%llu", (unsigned long long)site.throws);
+      ImGui::TableNextColumn(); ImGui::Text("%.1f", total_throws ? 100.0 * site.throws / total_throws : 0.0);
+      ImGui::TableNextColumn(); ImGui::TextUnformatted(site.type.c_str());
+      ImGui::TableNextColumn();
+      ImGui::PushID((void*)(uintptr_t)site.hash);
+      if (ImGui::TreeNodeEx(site.location.c_str(), ImGuiTreeNodeFlags_SpanAvailWidth)) {
+        for (size_t f = 1; f < site.frames.size(); f++)
+          ImGui::TextDisabled("%s", site.frames[f].c_str());
+        ImGui::TreePop();
+      }
+      ImGui::PopID();
+    }
+    ImGui::EndTable();
+  }
+
+  ImGui::End();
+}
+
+void ImGuiLayer::DrawSignalsWindow() {
+  if (!m_SignalsWindow_open) return;
+  if (!ImGui::Begin("Signals", &m_SignalsWindow_open)) {
+    ImGui::End();
+    return;
+  }
+  Profiler::Scope p("Signals");
+  Signals& signals = debugger.GetSignals();
+
+  // Same as "handle <signal> pass nostop", works before launch too
+  ImGui::SetNextItemWidth(150.f);
+  bool add = ImGui::InputTextWithHint("##signal", "SIGPROF", &signalName, ImGuiInputTextFlags_EnterReturnsTrue);
+  ImGui::SameLine();
+  add |= ImGui::Button("Pass without stopping");
+  if (add && !signalName.empty())
+    signals.Set(debugger.GetProcess(), signalName, true, false, std::nullopt);
+  ImGui::TextDisabled("Passed signals resume inside LLDB, with notify on they are only counted");
+
+  // Rate over the last half second
+  const double now = ImGui::GetTime();
+  const uint64_t total_passed = signals.GetTotalPassed();
+  if (now - signalRateTime >= 0.5) {
+    signalRate = total_passed >= signalRatePassed
+      ? (float)((total_passed - signalRatePassed) / (now - signalRateTime))
+      : 0.f;
+    signalRatePassed = total_passed;
+    signalRateTime = now;
+  }
+  ImGui::Text("Passed: %llu | %.0f signals/s", (unsigned long long)total_passed, signalRate);
+
+  auto policies = signals.GetPolicies();
+  ImGuiTableFlags table_flags = ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersV | ImGuiTableFlags_BordersOuter | ImGuiTableFlags_ScrollY | ImGuiTableFlags_SizingFixedFit;
+  if (ImGui::BeginTable("SignalPolicies", 6, table_flags)) {
+    ImGui::TableSetupScrollFreeze(0, 1);
+    ImGui::TableSetupColumn("Signal", ImGuiTableColumnFlags_WidthStretch);
+    ImGui::TableSetupColumn("#");
+    ImGui::TableSetupColumn("Pass");
+    ImGui::TableSetupColumn("Stop");
+    ImGui::TableSetupColumn("Notify");
+    ImGui::TableSetupColumn("Passed");
+    ImGui::TableHeadersRow();
+    ImGuiListClipper clipper;
+    clipper.Begin((int)policies.size());
+    while (clipper.Step()) {
+      for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++) {
+        const auto& policy = policies[i];
+        ImGui::PushID(policy.name.c_str());
+        ImGui::TableNextRow();
+        ImGui::TableNextColumn(); ImGui::TextUnformatted(policy.name.c_str());
+        ImGui::TableNextColumn();
+        if (policy.number) ImGui::Text("%d", policy.number);
+        else ImGui::TextDisabled("-");
+        bool pass = policy.pass, stop = policy.stop, notify = policy.notify;
+        ImGui::TableNextColumn();
+        if (ImGui::Checkbox("##pass", &pass))
+          signals.Set(debugger.GetProcess(), policy.name, pass, std::nullopt, std::nullopt);
+        ImGui::TableNextColumn();
+        if (ImGui::Checkbox("##stop", &stop))
+          signals.Set(debugger.GetProcess(), policy.name, std::nullopt, stop, std::nullopt);
+        ImGui::TableNextColumn();
+        if (ImGui::Checkbox("##notify", &notify))
+          signals.Set(debugger.GetProcess(), policy.name, std::nullopt, std::nullopt, notify);
+        ImGui::TableNextColumn();
+        if (policy.notify || policy.passed) ImGui::Text("%llu", (unsigned long long)policy.passed);
+        else ImGui::TextDisabled("-");
+        ImGui::PopID();
+      }
+    }
+    clipper.End();
+    ImGui::EndTable();
+  }
+
+  ImGui::End();
+}
+
+void ImGuiLayer::DrawArrayWindow() {
+  if (!m_ArrayWindow_open) return;
+  if (!ImGui::Begin("Array", &m_ArrayWindow_open)) {
+    ImGui::End();
+    return;
+  }
+  Profiler::Scope p("Array");
+  if (!arrayView.IsValid()) {
+    ImGui::TextDisabled("Expand an array or vector in Locals and pick \"View as array\"");
+    ImGui::End();
+    return;
+  }
+
+  const auto& source = arrayView.GetSource();
+  ImGui::Text("%s: %llu x %s at 0x%llx", arrayView.GetName().c_str(),
+    (unsigned long long)source.count, source.element_type.c_str(), (unsigned long long)source.address);
+  ImGui::Text("Read in %.2f ms at stop %u", arrayView.GetReadMs(), arrayView.GetStopId());
+  auto process = debugger.GetProcess();
+  if (process.IsValid() && process.GetStopID() != arrayView.GetStopId()) {
+    ImGui::SameLine();
+    ImGui::TextColored(ImVec4(1.f, 0.6f, 0.f, 1.f), "(stale)");
+    ImGui::SameLine();
+    if (ImGui::SmallButton("Reread")) {
+      // Copied, a failed read resets the view
+      auto reread = source;
+      arrayView.Read(process, reread, std::string(arrayView.GetName()));
+    }
+  }
+  if (!arrayView.IsValid()) {
+    ImGui::End();
+    return;
+  }
+
+  ImGui::Checkbox("Statistics", &arrayViewStats);
+  if (arrayViewStats && arrayView.GetCount() > 0) {
+    const auto& stats = arrayView.GetStats();
+    ImGui::SameLine();
+    ImGui::Text("min %g | max %g | mean %g (%.2f ms)", stats.min, stats.max, stats.mean, stats.ms);
+  }
+
+  ImGuiTableFlags table_flags = ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersV | ImGuiTableFlags_BordersOuter | ImGuiTableFlags_ScrollY;
+  if (ImGui::BeginTable("ArrayElements", 2, table_flags)) {
+    ImGui::TableSetupScrollFreeze(0, 1);
+    ImGui::TableSetupColumn("Index", ImGuiTableColumnFlags_WidthFixed);
+    ImGui::TableSetupColumn("Value", ImGuiTableColumnFlags_WidthStretch);
+    ImGui::TableHeadersRow();
+    // Only the visible rows are decoded
+    char text[64];
+    ImGuiListClipper clipper;
+    clipper.Begin((int)std::min<uint64_t>(arrayView.GetCount(), INT_MAX));
+    while (clipper.Step()) {
+      for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++) {
+        ImGui::TableNextRow();
+        ImGui::TableNextColumn(); ImGui::Text("%d", i);
+        ImGui::TableNextColumn();
+        arrayView.FormatElement((uint64_t)i, text, sizeof(text));
+        ImGui::TextUnformatted(text);
+      }
+    }
+    clipper.End();
+    ImGui::EndTable();
+  }
+  ImGui::End();
+}
+
+void ImGuiLayer::DrawWatchWindow() {
+  if (!m_WatchWindow_open) return;
+  if (!ImGui::Begin("Watch", &m_WatchWindow_open)) {
+    ImGui::End();
+    return;
+  }
+  Profiler::Scope p("Watch");
+  Watches& watches = debugger.GetWatches();
+
+  ImGui::SetNextItemWidth(-60.f);
+  bool add = ImGui::InputTextWithHint("##expression", "Expression", &watchExpression, ImGuiInputTextFlags_EnterReturnsTrue);
+  ImGui::SameLine();
+  add |= ImGui::Button("Add");
+  if (add && !watchExpression.empty()) {
+    watches.Add(watchExpression);
+    watchExpression.clear();
+  }
+  int timeout_ms = (int)watches.GetTimeoutMs();
+  ImGui::SetNextItemWidth(120.f);
+  if (ImGui::InputInt("Timeout (ms)", &timeout_ms, 50, 500, ImGuiInputTextFlags_EnterReturnsTrue))
+    watches.SetTimeoutMs((uint32_t)std::clamp<int>(timeout_ms, 1, 60000));
+
+  // Evaluated on the stop queue, this only picks up the latest batch
+  auto snapshot = debugger.GetWatchSnapshot();
+  auto expressions = watches.GetExpressions();
+  const bool current = snapshot && snapshot->version == watches.GetVersion() && debugger.IsWatchSnapshotCurrent(*snapshot);
+  if (snapshot)
+    ImGui::TextDisabled("Stop %u, thread %u, frame %u, %.2f ms for %zu expressions%s", snapshot->stop_id, snapshot->thread_index, snapshot->frame_id, snapshot->total_ms, snapshot->results.size(), current ? "" : " (updating)");
+
+  ImGuiTableFlags table_flags = ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersV | ImGuiTableFlags_BordersOuter | ImGuiTableFlags_Resizable | ImGuiTableFlags_ScrollY;
+  if (ImGui::BeginTable("Watches", 5, table_flags)) {
+    ImGui::TableSetupScrollFreeze(0, 1);
+    ImGui::TableSetupColumn("Expression");
+    ImGui::TableSetupColumn("Value", ImGuiTableColumnFlags_WidthStretch);
+    ImGui::TableSetupColumn("Type");
+    ImGui::TableSetupColumn("ms", ImGuiTableColumnFlags_WidthFixed);
+    ImGui::TableSetupColumn("", ImGuiTableColumnFlags_WidthFixed);
+    ImGui::TableHeadersRow();
+    for (size_t i = 0; i < expressions.size(); i++) {
+      ImGui::PushID((int)i);
+      ImGui::TableNextRow();
+      ImGui::TableNextColumn(); ImGui::TextUnformatted(expressions[i].c_str());
+      // Results are matched by position only while the list is unchanged
+      const Watches::Result* result = current && i < snapshot->results.size() ? &snapshot->results[i] : nullptr;
+      ImGui::TableNextColumn();
+      if (!result)
+        ImGui::TextDisabled("...");
+      else if (result->error)
+        ImGui::TextColored(ImVec4(1.f, 0.4f, 0.4f, 1.f), "%s", result->value.c_str());
+      else if (result->changed)
+        ImGui::TextColored(ImVec4(1.f, 0.8f, 0.2f, 1.f), "%s", result->value.c_str());
+      else
+        ImGui::TextUnformatted(result->value.c_str());
+      ImGui::TableNextColumn(); if (result) ImGui::TextUnformatted(result->type.c_str());
+      ImGui::TableNextColumn(); if (result) ImGui::Text("%.2f", result->ms);
+      ImGui::TableNextColumn();
+      if (ImGui::SmallButton("x"))
+        watches.Remove(i);
+      ImGui::PopID();
+    }
+    ImGui::EndTable();
+  }
+  ImGui::End();
+}
+
+void ImGuiLayer::SetMemoryAddress(lldb::addr_t address) {
+  static constexpr lldb::addr_t Span = 16 << 20;
+  static constexpr lldb::addr_t Fallback = 1 << 20;
+  auto process = debugger.GetProcess();
+  lldb::SBMemoryRegionInfo region;
+  if (process.GetMemoryRegionInfo(address, region).Success() && region.IsMapped()) {
+    memoryRegionStart = region.GetRegionBase();
+    memoryRegionEnd = region.GetRegionEnd();
+  }
+  else {
+    // Unmapped or no region info, show a neighbourhood and let reads fail
+    memoryRegionStart = (address & ~(Fallback - 1)) - std::min<lldb::addr_t>(address & ~(Fallback - 1), Fallback);
+    memoryRegionEnd = (address & ~(Fallback - 1)) + Fallback;
+  }
+  // Center the address in the span, clamped to the region
+  lldb::addr_t start = address > Span / 2 ? (address - Span / 2) & ~(lldb::addr_t)15 : 0;
+  start = std::max<lldb::addr_t>(start, memoryRegionStart);
+  if (memoryRegionEnd - memoryRegionStart > Span)
+    start = std::min<lldb::addr_t>(start, memoryRegionEnd - Span);
+  else
+    start = memoryRegionStart;
+  memoryAddress = address;
+  memorySpanStart = start & ~(lldb::addr_t)15;
+  memoryScrollToRow = (int)((address - memorySpanStart) / 16);
+}
+
+void ImGuiLayer::DrawMemoryWindow() {
+  if (!m_MemoryWindow_open) return;
+  if (!ImGui::Begin("Memory", &m_MemoryWindow_open)) {
+    ImGui::End();
+    return;
+  }
+  Profiler::Scope p("Memory");
+  static constexpr lldb::addr_t Span = 16 << 20;
+  static constexpr int PrefetchPages = 4;
+  MemoryCache& cache = debugger.GetMemoryCache();
+  auto process = debugger.GetProcess();
+
+  ImGui::SetNextItemWidth(-60.f);
+  bool go = ImGui::InputTextWithHint("##address", "Address or expression", &memoryAddressInput, ImGuiInputTextFlags_EnterReturnsTrue);
+  ImGui::SameLine();
+  go |= ImGui::Button("Go");
+  if (go && !memoryAddressInput.empty() && process.IsValid() && process.GetState() == lldb::eStateStopped) {
+    char* end = nullptr;
+    uint64_t address = std::strtoull(memoryAddressInput.c_str(), &end, 0);
+    if (end && *end == '\0') {
+      SetMemoryAddress(address);
+    }
+    else {
+      // Explicit user action, evaluated once in the selected frame
+      auto frame = process.GetSelectedThread().GetSelectedFrame();
+      auto value = frame.EvaluateExpression(memoryAddressInput.c_str());
+      if (value.IsValid() && value.GetError().Success())
+        SetMemoryAddress(value.GetValueAsUnsigned());
+      else
+        Logger::Warn("Memory: can't evaluate '{}'", memoryAddressInput);
+    }
+  }
+
+  static const char* view_types[] = {"u8", "u32", "f32", "f64"};
+  ImGui::SetNextItemWidth(80.f);
+  ImGui::Combo("View", &memoryViewType, view_types, IM_ARRAYSIZE(view_types));
+  ImGui::SameLine();
+  uint64_t reads = cache.GetReads(), hits = cache.GetHits();
+  ImGui::TextDisabled("%zu pages cached, %llu reads, %.1f%% hits", cache.GetSize(), (unsigned long long)reads,
+    reads + hits ? 100.0 * hits / (reads + hits) : 0.0);
+
+  if (memoryRegionEnd <= memoryRegionStart) {
+    ImGui::TextDisabled("Enter an address");
+    ImGui::End();
+    return;
+  }
+  const lldb::addr_t span_end = std::min<lldb::addr_t>(memorySpanStart + Span, memoryRegionEnd);
+  ImGui::Text("Region 0x%llx-0x%llx", (unsigned long long)memoryRegionStart, (unsigned long long)memoryRegionEnd);
+  if (memoryRegionEnd - memoryRegionStart > Span) {
+    // Page the span through large mappings
+    ImGui::SameLine();
+    ImGui::BeginDisabled(memorySpanStart <= memoryRegionStart);
+    if (ImGui::SmallButton("<<")) {
+      memorySpanStart -= std::min<lldb::addr_t>(Span / 2, memorySpanStart - memoryRegionStart);
+      memoryScrollToRow = 0;
+    }
+    ImGui::EndDisabled();
+    ImGui::SameLine();
+    ImGui::BeginDisabled(span_end >= memoryRegionEnd);
+    if (ImGui::SmallButton(">>")) {
+      memorySpanStart += std::min<lldb::addr_t>(Span / 2, memoryRegionEnd - span_end);
+      memoryScrollToRow = 0;
+    }
+    ImGui::EndDisabled();
+  }
+
+  // Pins snapshot at every stop, the rows below show the latest changes
+  MemorySnapshots& snapshots = debugger.GetMemorySnapshots();
+  ImGui::SetNextItemWidth(120.f);
+  ImGui::InputInt("Bytes", &memoryPinSize, 4096, 1 << 20);
+  memoryPinSize = std::clamp<int>(memoryPinSize, 1, (int)std::min<uint64_t>(MemorySnapshots::MaxSize, INT32_MAX));
+  ImGui::SameLine();
+  if (ImGui::Button("Pin") && snapshots.Add(memoryAddress, (uint64_t)memoryPinSize))
+    debugger.UpdateMemorySnapshots();
+  auto pins = snapshots.GetPins();
+  if (!pins.empty() && ImGui::CollapsingHeader("Pinned", ImGuiTreeNodeFlags_DefaultOpen)) {
+    ImGuiTableFlags table_flags = ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersV | ImGuiTableFlags_BordersOuter;
+    if (ImGui::BeginTable("Pins", 7, table_flags)) {
+      ImGui::TableSetupColumn("Address");
+      ImGui::TableSetupColumn("Bytes");
+      ImGui::TableSetupColumn("Stops");
+      ImGui::TableSetupColumn("Resident");
+      ImGui::TableSetupColumn("Last change", ImGuiTableColumnFlags_WidthStretch);
+      ImGui::TableSetupColumn("Diff ms");
+      ImGui::TableSetupColumn("", ImGuiTableColumnFlags_WidthFixed);
+      ImGui::TableHeadersRow();
+      for (const auto& pin : pins) {
+        ImGui::PushID((int)pin.id);
+        ImGui::TableNextRow();
+        ImGui::TableNextColumn(); ImGui::Text("0x%llx", (unsigned long long)pin.address);
+        ImGui::TableNextColumn(); ImGui::Text("%llu", (unsigned long long)pin.size);
+        ImGui::TableNextColumn(); ImGui::Text("%u", pin.stops);
+        ImGui::TableNextColumn(); ImGui::Text("%.1f KiB", pin.resident_bytes / 1024.0);
+        const MemorySnapshots::Delta* latest = pin.deltas.empty() ? nullptr : pin.deltas.back().get();
+        ImGui::TableNextColumn();
+        if (!latest)
+          ImGui::TextDisabled("-");
+        else if (latest->ranges.empty())
+          ImGui::TextDisabled("none (stop %u)", latest->stop_id);
+        else {
+          ImGui::Text("%zu bytes in %zu ranges (stop %u)", latest->bytes.size(), latest->ranges.size(), latest->stop_id);
+          ImGui::SameLine();
+          if (ImGui::SmallButton("Show"))
+            SetMemoryAddress(pin.address + latest->ranges.front().offset);
+        }
+        ImGui::TableNextColumn(); if (latest) ImGui::Text("%.2f", latest->diff_ms);
+        ImGui::TableNextColumn();
+        if (ImGui::SmallButton("x"))
+          snapshots.Remove(pin.id);
+        ImGui::PopID();
+      }
+      ImGui::EndTable();
+    }
+  }
+
+  if (!process.IsValid() || process.GetState() != lldb::eStateStopped) {
+    ImGui::TextDisabled("Process is running");
+    ImGui::End();
+    return;
+  }
+
+  // Only a pin's latest delta is highlighted, and only if it's for this stop
+  const uint32_t stop_id = process.GetStopID();
+  auto changed = [&](lldb::addr_t address) {
+    for (const auto& pin : pins) {
+      if (pin.deltas.empty() || pin.deltas.back()->stop_id != stop_id) continue;
+      if (address + 16 <= pin.address || address >= pin.address + pin.size) continue;
+      const uint64_t offset = address > pin.address ? address - pin.address : 0;
+      if (pin.deltas.back()->Intersects(offset, address + 16 - pin.address - offset))
+        return true;
+    }
+    return false;
+  };
+
+  ImGui::BeginChild("##rows", ImVec2(0, 0), false, ImGuiWindowFlags_HorizontalScrollbar);
+  const int rows = (int)((span_end - memorySpanStart + 15) / 16);
+  const float line = ImGui::GetTextLineHeightWithSpacing();
+  if (memoryScrollToRow >= 0) {
+    ImGui::SetScrollY(memoryScrollToRow * line);
+    memoryScrollToRow = -1;
+  }
+  ImGuiListClipper clipper;
+  clipper.Begin(rows, line);
+  lldb::addr_t first_visible = UINT64_MAX, last_visible = 0;
+  // Address, 48 for hex bytes, 2 spaces, 16 ascii
+  char text[128];
+  while (clipper.Step()) {
+    for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; row++) {
+      const lldb::addr_t address = memorySpanStart + (lldb::addr_t)row * 16;
+      first_visible = std::min<lldb::addr_t>(first_visible, address);
+      last_visible = std::max<lldb::addr_t>(last_visible, address + 16);
+      // Rows are 16 byte aligned so never straddle a page
+      auto page = cache.GetPage(process, address);
+      const uint32_t offset = (uint32_t)(address & (MemoryCache::PageSize - 1));
+      int n = snprintf(text, sizeof(text), "%016llx  ", (unsigned long long)address);
+      if (!page || page->readable < offset + 16) {
+        ImGui::TextDisabled("%s%s", text, "?? ?? ?? ?? ?? ?? ?? ?? ?? ?? ?? ?? ?? ?? ?? ??");
+        continue;
+      }
+      const uint8_t* bytes = page->bytes.data() + offset;
+      char* out = text + n;
+      switch (memoryViewType) {
+        case 0: {
+          char hex[32];
+          HexFormat::Bytes16(bytes, hex);
+          for (int i = 0; i < 16; i++) {
+            *out++ = hex[i * 2];
+            *out++ = hex[i * 2 + 1];
+            *out++ = ' ';
+          }
+          *out++ = ' ';
+          HexFormat::Ascii16(bytes, out);
+          out += 16;
+          break;
+        }
+        case 1: {
+          char hex[32];
+          HexFormat::Words16(bytes, hex);
+          for (int i = 0; i < 4; i++) {
+            memcpy(out, hex + i * 8, 8);
+            out += 8;
+            *out++ = ' ';
+          }
+          break;
+        }
+        case 2: {
+          float values[4];
+          memcpy(values, bytes, sizeof(values));
+          for (float v : values)
+            out += snprintf(out, text + sizeof(text) - out, "%14.6g ", v);
+          break;
+        }
+        case 3: {
+          double values[2];
+          memcpy(values, bytes, sizeof(values));
+          for (double v : values)
+            out += snprintf(out, text + sizeof(text) - out, "%24.15g ", v);
+          break;
+        }
+      }
+      const bool highlight = changed(address);
+      if (highlight)
+        ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(1.f, 0.8f, 0.2f, 1.f));
+      ImGui::TextUnformatted(text, out);
+      if (highlight)
+        ImGui::PopStyleColor();
+    }
+  }
+  ImGui::EndChild();
+
+  // Warm the pages around what's on screen for the next scroll
+  if (first_visible < last_visible) {
+    const lldb::addr_t ahead = PrefetchPages * MemoryCache::PageSize;
+    lldb::addr_t first = first_visible > memoryRegionStart + ahead ? first_visible - ahead : memoryRegionStart;
+    lldb::addr_t last = std::min<lldb::addr_t>(last_visible + ahead, memoryRegionEnd);
+    cache.Prefetch(process, first, last);
+  }
+  ImGui::End();
+}
+
+void ImGuiLayer::DrawDisassemblyWindow() {
+  if (!m_DisassemblyWindow_open) return;
+  if (!ImGui::Begin("Disassembly", &m_DisassemblyWindow_open)) {
+    ImGui::End();
+    return;
+  }
+  Profiler::Scope p("Disassembly");
+  Disassembly& cache = debugger.GetDisassemblyCache();
+  auto view = debugger.GetDisassembly();
+
+  ImGui::Checkbox("Source", &disassemblyShowSource);
+  ImGui::SameLine();
+  ImGui::TextDisabled("%zu functions cached, %llu hits, %llu misses", cache.GetSize(),
+    (unsigned long long)cache.GetHits(), (unsigned long long)cache.GetMisses());
+  if (!view || !view->listing) {
+    if (view)
+      ImGui::TextDisabled("Nothing to disassemble at 0x%llx", (unsigned long long)view->pc);
+    else
+      ImGui::TextDisabled("Not stopped");
+    ImGui::End();
+    return;
+  }
+  const Disassembly::Listing& listing = *view->listing;
+  ImGui::Text("%s", listing.name.c_str());
+  ImGui::SameLine();
+  ImGui::TextDisabled("%zu instructions, disassembled in %.2f ms", listing.instructions.size(), listing.ms);
+
+  // Rows are either all instructions or the mixed list with source lines
+  const bool mixed = disassemblyShowSource && !listing.sources.empty();
+  const int rows = (int)(mixed ? listing.mixed.size() : listing.instructions.size());
+  const int32_t pc_index = listing.Find(view->pc);
+
+  ImGuiTableFlags table_flags = ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersV | ImGuiTableFlags_BordersOuter | ImGuiTableFlags_Resizable | ImGuiTableFlags_ScrollY;
+  if (ImGui::BeginTable("Instructions", 3, table_flags)) {
+    ImGui::TableSetupScrollFreeze(0, 1);
+    ImGui::TableSetupColumn("Address", ImGuiTableColumnFlags_WidthFixed);
+    ImGui::TableSetupColumn("Instruction", ImGuiTableColumnFlags_WidthStretch);
+    ImGui::TableSetupColumn("Comment", ImGuiTableColumnFlags_WidthStretch);
+    ImGui::TableHeadersRow();
+
+    const float line = ImGui::GetTextLineHeightWithSpacing();
+    if (view != disassemblyScrolledView) {
+      disassemblyScrolledView = view;
+      int pc_row = pc_index;
+      if (mixed && pc_index >= 0)
+        pc_row = (int)(std::find(listing.mixed.begin(), listing.mixed.end(), (uint32_t)pc_index) - listing.mixed.begin());
+      if (pc_row >= 0)
+        ImGui::SetScrollY(std::max<float>(0.f, pc_row * line - ImGui::GetContentRegionAvail().y / 2));
+    }
+
+    ImGuiListClipper clipper;
+    clipper.Begin(rows, line);
+    while (clipper.Step()) {
+      for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; row++) {
+        ImGui::TableNextRow();
+        const uint32_t entry = mixed ? listing.mixed[row] : (uint32_t)row;
+        if (entry & Disassembly::SourceFlag) {
+          const Disassembly::SourceLine& source = listing.sources[entry & ~Disassembly::SourceFlag];
+          ImGui::TableNextColumn();
+          ImGui::TextDisabled("%s:%u", source.file.c_str(), source.line);
+          ImGui::TableNextColumn();
+          ImGui::TextColored(ImVec4(0.5f, 0.8f, 0.5f, 1.f), "%s", source.text.c_str());
+          continue;
+        }
+        const Disassembly::Instruction& instruction = listing.instructions[entry];
+        if ((int32_t)entry == pc_index)
+          ImGui::TableSetBgColor(ImGuiTableBgTarget_RowBg0, ImGui::GetColorU32(ImVec4(0.8f, 0.6f, 0.1f, 0.35f)));
+        ImGui::TableNextColumn(); ImGui::Text("0x%llx", (unsigned long long)instruction.address);
+        ImGui::TableNextColumn(); ImGui::Text("%-8s %s", instruction.mnemonic.c_str(), instruction.operands.c_str());
+        ImGui::TableNextColumn(); if (!instruction.comment.empty()) ImGui::TextDisabled("%s", instruction.comment.c_str());
+      }
+    }
+    ImGui::EndTable();
+  }
+  ImGui::End();
+}
+
+void ImGuiLayer::DrawRegistersWindow() {
+  if (!m_RegistersWindow_open) return;
+  if (!ImGui::Begin("Registers", &m_RegistersWindow_open)) {
+    ImGui::End();
+    return;
+  }
+  Profiler::Scope p("Registers");
+  // Read once per stop and frame by the debugger, no SB calls from here
+  auto snapshot = debugger.GetRegisters();
+  if (!snapshot) {
+    ImGui::TextDisabled("Not stopped");
+    ImGui::End();
+    return;
+  }
+
+  static const char* lanes[] = {"i8", "i16", "i32", "i64", "f32", "f64"};
+  static_assert(IM_ARRAYSIZE(lanes) == (int)Registers::Lane::Count);
+  ImGui::SetNextItemWidth(80.f);
+  ImGui::Combo("Lanes", &registersLane, lanes, IM_ARRAYSIZE(lanes));
+  ImGui::SameLine();
+  ImGui::Checkbox("Changed only", &registersChangedOnly);
+  ImGui::SameLine();
+  ImGui::TextDisabled("Stop %u, frame %u, %zu changed, read in %.2f ms", snapshot->stop_id, snapshot->frame_id, snapshot->changed, snapshot->ms);
+
+  const Registers::Lane lane = (Registers::Lane)registersLane;
+  const ImVec4 changed_color(1.f, 0.8f, 0.2f, 1.f);
+  ImGuiTableFlags table_flags = ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersV | ImGuiTableFlags_BordersOuter | ImGuiTableFlags_Resizable;
+  for (size_t s = 0; s < snapshot->sets.size(); s++) {
+    const Registers::Set& set = snapshot->sets[s];
+    ImGui::PushID((int)s);
+    // General purpose registers come first
+    if (ImGui::CollapsingHeader(set.name.c_str(), s == 0 ? ImGuiTreeNodeFlags_DefaultOpen : 0) &&
+        ImGui::BeginTable("Registers", 2, table_flags)) {
+      ImGui::TableSetupColumn("Name", ImGuiTableColumnFlags_WidthFixed);
+      ImGui::TableSetupColumn("Value", ImGuiTableColumnFlags_WidthStretch);
+      for (const Registers::Register& reg : set.registers) {
+        if (registersChangedOnly && !reg.changed) continue;
+        ImGui::TableNextRow();
+        ImGui::TableNextColumn();
+        bool open = false;
+        if (reg.IsVector()) {
+          open = ImGui::TreeNodeEx(reg.name.c_str(), ImGuiTreeNodeFlags_SpanFullWidth);
+        }
+        else if (reg.changed) {
+          ImGui::TextColored(changed_color, "%s", reg.name.c_str());
+        }
+        else {
+          ImGui::TextUnformatted(reg.name.c_str());
+        }
+        ImGui::TableNextColumn();
+        if (reg.changed)
+          ImGui::TextColored(changed_color, "%s", reg.value.c_str());
+        else
+          ImGui::TextUnformatted(reg.value.c_str());
+        if (!open) continue;
+
+        // Lanes low to high, the way the intrinsics index them, 16 to a line
+        ImGui::TableNextRow();
+        ImGui::TableNextColumn();
+        ImGui::TextDisabled("%s x%zu", Registers::LaneName(lane), reg.bytes.size() / Registers::LaneSize(lane));
+        ImGui::TableNextColumn();
+        const uint32_t count = (uint32_t)(reg.bytes.size() / Registers::LaneSize(lane));
+        for (uint32_t i = 0; i < count; i++) {
+          if (i % 16) ImGui::SameLine();
+          char text[32];
+          const int length = (int)reg.FormatLane(lane, i, text, sizeof(text));
+          if (reg.LaneChanged(lane, i))
+            ImGui::TextColored(changed_color, "%.*s", length, text);
+          else
+            ImGui::TextUnformatted(text, text + length);
+          if (ImGui::IsItemHovered())
+            ImGui::SetTooltip("[%u]", i);
+        }
+        ImGui::TreePop();
+      }
+      ImGui::EndTable();
+    }
+    ImGui::PopID();
+  }
+  ImGui::End();
+}
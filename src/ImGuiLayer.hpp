@@ -2,13 +2,22 @@
 #define IMGUI_LAYER_HPP
 #include "FileHierarchy.hpp"
 #include "FileContext.hpp"
+#include "FrameArena.hpp"
+#include "Sampler.hpp"
+#include "VariableTree.hpp"
+#include "ArrayView.hpp"
+#include "ValueDiff.hpp"
+#include "Disassembly.hpp"
+#include "Registers.hpp"
+#include "LLDBDebugger.hpp"
+#include <memory>
 #include <unordered_map>
 #include <vector>
 #include <queue>
 #include <mutex>
 struct Window;
 struct ImGuiInputTextCallbackData;
-class LLDBDebugger;
+class Texture;
 
 class ImGuiLayer {
   friend LLDBDebugger;
@@ -26,12 +35,14 @@ class ImGuiLayer {
     void DrawFilesNotFoundModal();
     void SwitchToCodeFile(const std::filesystem::path&);
     void PushIOLine(const std::string&);
+    void QueueFiles(const std::vector<std::filesystem::path>&);
   
   protected:
     bool FrontendLoadFile(FileHierarchy::TreeNode&);
 
   private:
     bool LoadFile(FileHierarchy::TreeNode&);
+    void ApplyQueuedFiles();
     void ProcessArguments(const char*, char*, int, char*[100]);
 
   private:
@@ -43,15 +54,44 @@ class ImGuiLayer {
     void DrawBreakpointsWindow();
     void DrawLLDBCommandWindow();
     void DrawProcessIOWindow();
+    void DrawPerformanceWindow();
+    void DrawSamplerWindow();
+    void DrawCallTreeNode(const Sampler::Profile&, uint32_t index);
+    void DrawFlameGraph(const Sampler::Profile&);
+    void DrawStacksWindow();
+    void DrawThreadMonitorWindow();
+    void DrawResourcesWindow();
+    void DrawTracepointsWindow();
+    void DrawExceptionsWindow();
+    void DrawSignalsWindow();
+    void DrawArrayWindow();
+    void DrawWatchWindow();
+    void DrawMemoryWindow();
+    void DrawDisassemblyWindow();
+    void DrawRegistersWindow();
+    void SetMemoryAddress(lldb::addr_t address);
 
-    bool ShowHierarchyItem(FileHierarchy::TreeNode&, const std::filesystem::path&, const std::filesystem::path&);
-    void FileHierarchyRecursive(const std::filesystem::path&, FileHierarchy::TreeNode&);
+    struct FileBrowserRow {
+      FileHierarchy::TreeNode* node;
+      std::string label;
+      const Texture* texture;
+      int depth;
+      bool leaf;
+    };
+    void ShowHierarchyItem(const FileBrowserRow&);
+    void FileHierarchyRecursive(const std::filesystem::path&, FileHierarchy::TreeNode&, int depth);
+    void RebuildFileBrowserRows();
     void DrawFileBrowser();
 
+    struct HotLocation {
+      const LLDBDebugger::BreakpointStats* breakpoint;
+      const LLDBDebugger::LocationStats* location;
+    };
+
   private:
     void DrawRunButton();
     void DrawCodeFile(FileHierarchy::TreeNode&);
-    void DrawLocal(lldb::SBValue&, const std::string& = "");
+    void DrawLocal(uint32_t node);
 
   private:
     static int TextEditCallbackStub(ImGuiInputTextCallbackData* data);
@@ -62,11 +102,87 @@ class ImGuiLayer {
     FileHierarchy fh;
     std::vector<FileHierarchy::TreeNode*> openFiles;
     bool m_FilesNotFoundModal_open = false;
+    bool m_PerformanceWindow_open = false;
+    bool m_SamplerWindow_open = false;
+    bool m_StacksWindow_open = false;
+    bool m_ThreadMonitorWindow_open = false;
+    bool m_ResourcesWindow_open = false;
+    bool m_TracepointsWindow_open = false;
+    bool m_ExceptionsWindow_open = false;
+    bool m_SignalsWindow_open = false;
+    bool m_ArrayWindow_open = false;
+    bool m_WatchWindow_open = false;
+    bool m_MemoryWindow_open = false;
+    bool m_DisassemblyWindow_open = false;
+    bool m_RegistersWindow_open = false;
+
+  private:
+    std::string tracepointLocation;
+    std::string tracepointMessage;
+    uint64_t tracepointRateHits = 0;
+    double tracepointRateTime = 0.0;
+    float tracepointRate = 0.f;
+    std::vector<std::string> tracepointLogLines;
+    uint64_t exceptionRateThrows = 0;
+    double exceptionRateTime = 0.0;
+    float exceptionRate = 0.f;
+    std::string signalName;
+    uint64_t signalRatePassed = 0;
+    double signalRateTime = 0.0;
+    float signalRate = 0.f;
+    std::string watchExpression;
+    // The memory window scrolls over a span of the mapping at a time, a float
+    //   scroll position can't address a multi-GB one a row at a time
+    std::string memoryAddressInput;
+    lldb::addr_t memoryRegionStart = 0;
+    lldb::addr_t memoryRegionEnd = 0;
+    lldb::addr_t memorySpanStart = 0;
+    int memoryScrollToRow = -1;
+    int memoryViewType = 0;
+    lldb::addr_t memoryAddress = 0;
+    int memoryPinSize = 4096;
+    bool disassemblyShowSource = true;
+    // Scrolls to the pc once per stop or frame change
+    std::shared_ptr<const Disassembly::View> disassemblyScrolledView;
+    int registersLane = (int)Registers::Lane::F32;
+    bool registersChangedOnly = false;
+    bool performanceCountSBCalls = false;
+    int threadMonitorRate = 10;
+    int samplerRate = 50;
     std::vector<const FileHierarchy::TreeNode*> m_FilesNotFoundModal_files;
 
+  private:
+    // Flattened list of the visible (expanded) file browser rows. Only rebuilt when
+    //   a folder is toggled or the hierarchy changes, never per frame.
+    std::vector<FileBrowserRow> fileBrowserRows;
+    bool fileBrowserRowsDirty = true;
+    uint64_t fileBrowserVersion = 0;
+    // Point into hotLocationsStats, rebuilt and sorted only when the debugger
+    //   publishes new stats or the sort changes
+    std::shared_ptr<const std::vector<LLDBDebugger::BreakpointStats>> hotLocationsStats;
+    std::vector<HotLocation> hotLocations;
+
+  private:
+    VariableTree localsTree;
+    std::shared_ptr<const ValueDiff::Changes> valueChanges;
+    ArrayView arrayView;
+    bool arrayViewStats = false;
+
+  private:
+    // Scratch memory for labels built during a frame, reset in Begin()
+    FrameArena frameArena;
+    uint64_t frameAllocationsStart = 0;
+    uint64_t lastFrameAllocations = 0;
+
   private:
     std::vector<std::string> processIOWindowItems;
     std::mutex processIOMutex;
+
+  private:
+    // Source files discovered off the UI thread (e.g. dlopen'd modules),
+    //   merged into the hierarchy at the start of the next frame
+    std::vector<std::filesystem::path> queuedFiles;
+    std::mutex queuedFilesMutex;
 };
 
 #endif
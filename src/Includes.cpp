@@ -45,4 +45,31 @@
 #include "Logger.hpp"
 #include "Util.hpp"
 #include "LLDBCommandParser.hpp"
+#include "TaskQueue.hpp"
+#include "ConcurrentSet.hpp"
+#include "FrameArena.hpp"
+#include "AllocationCounter.hpp"
+#include "Profiler.hpp"
+#include "RingBuffer.hpp"
+#include "Trace.hpp"
+#include "StopLatency.hpp"
+#include "Benchmark.hpp"
+#include "Sampler.hpp"
+#include "Stacks.hpp"
+#include "ProcFS.hpp"
+#include "ThreadMonitor.hpp"
+#include "ResourceMonitor.hpp"
+#include "Tracepoints.hpp"
+#include "Exceptions.hpp"
+#include "Signals.hpp"
+#include "ArrayView.hpp"
+#include "Formatters.hpp"
+#include "VariableTree.hpp"
+#include "Watches.hpp"
+#include "ValueDiff.hpp"
+#include "MemoryCache.hpp"
+#include "HexFormat.hpp"
+#include "MemorySnapshots.hpp"
+#include "Disassembly.hpp"
+#include "Registers.hpp"
 #include "Window.hpp"
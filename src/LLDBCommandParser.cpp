@@ -12,16 +12,20 @@ LLDB_CommandParser::ParsedCommand LLDB_CommandParser::Parse(const std::string& c
 
   // Parse short form first
   //  b main.cpp:3
+  //  b main.cpp:3 -i 10 -o if i == 42
   if (split.at(0) == "b") {
     if (split.size() == 1) return LLDB_CommandParser::Invalid("Incomplete breakpoint command");
     auto& where = split.at(1);
+    std::string options_error;
+    auto options = ParseBPOptions(command, split, 2, options_error);
+    if (!options) return LLDB_CommandParser::Invalid("{}", options_error);
     size_t colon = where.find(":");
     if (colon != std::string::npos) { // b <file>:<line>
       std::string file = where.substr(0, colon);
       std::string line = where.substr(colon + 1);
       try {
         int line_int = std::stoi(std::string(line));
-        return ParsedCommand{.type = ParsedCommandType::BREAKPOINT_FILE_LINE, .command = BPFileLine{file, line_int}};
+        return ParsedCommand{.type = ParsedCommandType::BREAKPOINT_FILE_LINE, .command = BPFileLine{file, line_int, *options}};
       } catch (std::invalid_argument e) {
         return LLDB_CommandParser::Invalid("Breakpoint line '{}' not an integer", line);
       } catch (std::out_of_range e) {
@@ -29,9 +33,45 @@ LLDB_CommandParser::ParsedCommand LLDB_CommandParser::Parse(const std::string& c
       }
     }
     else { // b <symbol>
-      return ParsedCommand{.type = ParsedCommandType::BREAKPOINT_SYMBOL, .command = BPSymbol{where}};
+      return ParsedCommand{.type = ParsedCommandType::BREAKPOINT_SYMBOL, .command = BPSymbol{where, *options}};
     }
   }
+  //  tp main.cpp:3 x is {x}
+  if (split.at(0) == "tp") {
+    if (split.size() < 3) return LLDB_CommandParser::Invalid("Usage: tp <file>:<line> <message>");
+    auto& where = split.at(1);
+    size_t colon = where.find(":");
+    if (colon == std::string::npos) return LLDB_CommandParser::Invalid("Tracepoint location '{}' is not <file>:<line>", where);
+    std::string file = where.substr(0, colon);
+    std::string line = where.substr(colon + 1);
+    // The message is the rest of the command as typed, spacing included
+    size_t message_start = command.find_first_not_of(" \t", command.find(where) + where.size());
+    try {
+      int line_int = std::stoi(std::string(line));
+      return ParsedCommand{.type = ParsedCommandType::TRACEPOINT_FILE_LINE, .command = TPFileLine{file, line_int, command.substr(message_start)}};
+    } catch (std::invalid_argument e) {
+      return LLDB_CommandParser::Invalid("Tracepoint line '{}' not an integer", line);
+    } catch (std::out_of_range e) {
+      return LLDB_CommandParser::Invalid("Tracepoint line '{}' out of range", line);
+    }
+  }
+  //  handle SIGPROF pass nostop nonotify
+  if (split.at(0) == "handle") {
+    if (split.size() < 3) return LLDB_CommandParser::Invalid("Usage: handle <signal> [no]pass [no]stop [no]notify");
+    SignalHandle handle{.signal = split.at(1)};
+    for (size_t i = 2; i < split.size(); i++) {
+      const auto& word = split.at(i);
+      // "notify" starts with "no" too, only a known action after it negates
+      auto known = [](std::string_view action) { return action == "pass" || action == "stop" || action == "notify"; };
+      const bool negated = word.starts_with("no") && known(std::string_view(word).substr(2));
+      const std::string action = negated ? word.substr(2) : word;
+      if (action == "pass") handle.pass = !negated;
+      else if (action == "stop") handle.stop = !negated;
+      else if (action == "notify") handle.notify = !negated;
+      else return LLDB_CommandParser::Invalid("Unknown signal action '{}'", word);
+    }
+    return ParsedCommand{.type = ParsedCommandType::SIGNAL_HANDLE, .command = handle};
+  }
   if (split.size() == 1 && split.at(0) == "n") {
     return ParsedCommand{.type = ParsedCommandType::NEXT};
   }
@@ -47,6 +87,45 @@ LLDB_CommandParser::ParsedCommand LLDB_CommandParser::Parse(const std::string& c
   return LLDB_CommandParser::Invalid("{} not valid", command);
 }
 
+std::optional<LLDB_CommandParser::BPOptions> LLDB_CommandParser::ParseBPOptions(const std::string& command, const std::vector<std::string>& split, size_t first, std::string& error) {
+  BPOptions options;
+  for (size_t i = first; i < split.size(); i++) {
+    if (split.at(i) == "-o") {
+      options.one_shot = true;
+    }
+    else if (split.at(i) == "-i") {
+      if (i + 1 >= split.size()) {
+        error = "-i needs an ignore count";
+        return std::nullopt;
+      }
+      try {
+        options.ignore_count = (uint32_t)std::stoul(split.at(++i));
+      } catch (const std::exception&) {
+        error = fmt::format("Ignore count '{}' not an integer", split.at(i));
+        return std::nullopt;
+      }
+    }
+    else if (split.at(i) == "if") {
+      // The condition is the rest of the command as typed, it can contain anything
+      size_t pos = 0;
+      for (size_t j = 0; j <= i; j++)
+        pos = command.find(split.at(j), pos) + split.at(j).size();
+      size_t start = command.find_first_not_of(" \t", pos);
+      if (start == std::string::npos) {
+        error = "if needs a condition";
+        return std::nullopt;
+      }
+      options.condition = command.substr(start);
+      break;
+    }
+    else {
+      error = fmt::format("Unknown breakpoint option '{}'", split.at(i));
+      return std::nullopt;
+    }
+  }
+  return options;
+}
+
 std::vector<std::string> LLDB_CommandParser::SplitBySpaces(const std::string& s) {
     std::vector<std::string> tokens;
     std::istringstream iss(s); // Create an input string stream from the string
@@ -3,6 +3,8 @@
 #include <string_view>
 #include <vector>
 #include <variant>
+#include <optional>
+#include <string>
 #include <fmt/core.h>
 
 class LLDB_CommandParser {
@@ -10,17 +12,39 @@ public:
   enum class ParsedCommandType : int {
     EMPTY = 0, INVALID,
     BREAKPOINT_FILE_LINE, BREAKPOINT_SYMBOL,
+    TRACEPOINT_FILE_LINE,
+    SIGNAL_HANDLE,
     RUN, CONTINUE, STEP, NEXT,
   };
   struct InvalidCmd {
     std::string message;
   };
+  // Trailing breakpoint options: [-i <ignore count>] [-o] [if <condition>]
+  struct BPOptions {
+    std::string condition;
+    uint32_t ignore_count = 0;
+    bool one_shot = false;
+  };
   struct BPFileLine {
     std::string file;
     int line;
+    BPOptions options;
   };
   struct BPSymbol {
     std::string symbol;
+    BPOptions options;
+  };
+  struct TPFileLine {
+    std::string file;
+    int line;
+    std::string message;
+  };
+  // Unset fields leave that part of the signal's policy alone
+  struct SignalHandle {
+    std::string signal;
+    std::optional<bool> pass;
+    std::optional<bool> stop;
+    std::optional<bool> notify;
   };
   struct ParsedCommand {
     ParsedCommandType type;
@@ -28,7 +52,9 @@ public:
       std::monostate,
       InvalidCmd,
       BPFileLine,
-      BPSymbol
+      BPSymbol,
+      TPFileLine,
+      SignalHandle
     > command;
   };
 public:
@@ -46,6 +72,8 @@ protected:
 
 private:
   std::vector<std::string> SplitBySpaces(const std::string& s);
+  // Parses split[first..] as breakpoint options, nullopt and message on error
+  std::optional<BPOptions> ParseBPOptions(const std::string& command, const std::vector<std::string>& split, size_t first, std::string& error);
 };
 
 #endif
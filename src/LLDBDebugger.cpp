@@ -4,6 +4,9 @@
 #include <stdexcept>
 #include "Logger.hpp"
 #include "Util.hpp"
+#include "Trace.hpp"
+#include "StopLatency.hpp"
+#include "Profiler.hpp"
 #ifndef _WIN32
 #include <unistd.h>
 #else
@@ -14,15 +17,24 @@
 #include <fstream>
 #include <cstdio>
 #include <cstring>
+#include <algorithm>
 
 LLDBDebugger::LLDBDebugger(): eventCallback(nullptr) {
     lldb::SBDebugger::Initialize();
     debugger = lldb::SBDebugger::Create();
     debugger.SetAsync(true);
+    // Logs enabled without a file come here, only "lldb api" ever is
+    debugger.SetLoggingCallback(&LLDBDebugger::OnLLDBLog, nullptr);
     listener = debugger.GetListener();
 }
 
 LLDBDebugger::~LLDBDebugger() {
+  moduleIndexQueue.Stop();
+  stopQueue.Stop();
+  sampler.Stop();
+  threadMonitor.Stop();
+  resourceMonitor.Stop();
+  memoryCache.Stop();
   auto error = process.Kill();
   if (error.Fail()) {
     Logger::Crit("Failed to kill process. Reason {}", error.GetCString());
@@ -39,6 +51,7 @@ void LLDBDebugger::SetEventCallback(std::function<void(const Event&)> _eventCall
 
 void LLDBDebugger::LaunchTarget(std::optional<std::vector<std::string>> args) {
   Logger::ScopedGroup g("LaunchTarget");
+  Trace::Scope t("Launch Target", "target");
   auto target = GetTarget();
   if (!target.IsValid()) {
     Logger::Crit("Failed to launch target. Target not valid.");
@@ -91,6 +104,14 @@ void LLDBDebugger::LaunchTarget(std::optional<std::vector<std::string>> args) {
   auto out_string = out_redirect.path.string();
 
   auto exe_path_string_esc = Util::StringEscapeBackslash(exe_path_string);
+
+  // Shared libraries resolved at launch and anything dlopen'd later only show up
+  //   through these broadcasts
+  target.GetBroadcaster().AddListener(listener,
+    lldb::SBTarget::eBroadcastBitModulesLoaded | lldb::SBTarget::eBroadcastBitModulesUnloaded);
+
+  // Load addresses from a previous run may not hold with this one
+  disassembly.Clear();
   process = target.Launch(
     listener,
     argv,
@@ -122,6 +143,11 @@ void LLDBDebugger::LaunchTarget(std::optional<std::vector<std::string>> args) {
     return;
   }
 
+  // The process is already running, a signal raised this early still gets
+  //   LLDB's default policy
+  signals.Apply(process);
+  resourceMonitor.Start((int)process.GetProcessID());
+
   if (lldbEventThread.joinable())
     lldbEventThread.join();
   lldbEventThread = std::thread([&]() {
@@ -143,11 +169,232 @@ lldb::SBProcess LLDBDebugger::GetProcess() {
   return process;
 }
 
+void LLDBDebugger::SetCountSBCalls(bool on) {
+  if (on == countingSBCalls) return;
+  countingSBCalls = on;
+  if (on) {
+    const char* categories[] = {"api", nullptr};
+    if (!debugger.EnableLog("lldb", categories))
+      Logger::Warn("Failed to enable the lldb api log, SB calls won't be counted");
+    return;
+  }
+  lldb::SBCommandReturnObject result;
+  debugger.GetCommandInterpreter().HandleCommand("log disable lldb api", result);
+}
+
+void LLDBDebugger::OnLLDBLog(const char* message, void*) {
+  // Runs on the thread making the call. The calls LLDB makes through its own
+  //   SB API while serving one are marked internal
+  if (message && !std::strstr(message, "[internal]"))
+    Profiler::CountSBCall();
+}
+
+Sampler& LLDBDebugger::GetSampler() {
+  return sampler;
+}
+
+ThreadMonitor& LLDBDebugger::GetThreadMonitor() {
+  return threadMonitor;
+}
+
+ResourceMonitor& LLDBDebugger::GetResourceMonitor() {
+  return resourceMonitor;
+}
+
+Tracepoints& LLDBDebugger::GetTracepoints() {
+  return tracepoints;
+}
+
+Exceptions& LLDBDebugger::GetExceptions() {
+  return exceptions;
+}
+
+Signals& LLDBDebugger::GetSignals() {
+  return signals;
+}
+
+std::shared_ptr<const Stacks::Snapshot> LLDBDebugger::GetStacks() {
+  std::lock_guard lock(stacksMutex);
+  if (process.IsValid() && process.GetState() == lldb::eStateStopped) {
+    uint32_t stop_id = process.GetStopID();
+    if (stop_id != stacksRequestedStop) {
+      stacksRequestedStop = stop_id;
+      stopQueue.Push([this, process = process]() mutable {
+        // Resumed before the queue got to it, the stacks are gone
+        if (process.GetState() != lldb::eStateStopped) return;
+        auto snapshot = std::make_shared<const Stacks::Snapshot>(Stacks::Collect(process));
+        std::lock_guard lock(stacksMutex);
+        stacks = std::move(snapshot);
+      });
+    }
+  }
+  return stacks;
+}
+
+Watches& LLDBDebugger::GetWatches() {
+  return watches;
+}
+
+MemoryCache& LLDBDebugger::GetMemoryCache() {
+  return memoryCache;
+}
+
+MemorySnapshots& LLDBDebugger::GetMemorySnapshots() {
+  return memorySnapshots;
+}
+
+void LLDBDebugger::UpdateMemorySnapshots() {
+  if (!memorySnapshots.HasPins()) return;
+  stopQueue.Push([this, process = process]() mutable {
+    if (process.GetState() != lldb::eStateStopped) return;
+    memorySnapshots.Update(process);
+  });
+}
+
+std::shared_ptr<const Watches::Snapshot> LLDBDebugger::GetWatchSnapshot() {
+  std::lock_guard lock(watchesMutex);
+  if (process.IsValid() && process.GetState() == lldb::eStateStopped) {
+    // Expression stops don't count towards the stop ID, so evaluating
+    //   can't trigger another batch
+    // Evaluated in the selected frame, so selecting another one asks again
+    lldb::SBThread thread = process.GetSelectedThread();
+    const uint32_t stop_id = process.GetStopID();
+    const uint32_t thread_index = thread.GetIndexID();
+    const uint32_t frame_id = thread.GetSelectedFrame().GetFrameID();
+    const uint64_t version = watches.GetVersion();
+    if (stop_id != watchesRequestedStop || thread_index != watchesRequestedThread || frame_id != watchesRequestedFrame || version != watchesRequestedVersion) {
+      watchesRequestedStop = stop_id;
+      watchesRequestedThread = thread_index;
+      watchesRequestedFrame = frame_id;
+      watchesRequestedVersion = version;
+      stopQueue.Push([this, process = process, thread_index, frame_id]() mutable {
+        if (process.GetState() != lldb::eStateStopped) return;
+        std::shared_ptr<const Watches::Snapshot> previous;
+        {
+          std::lock_guard lock(watchesMutex);
+          previous = watchSnapshot;
+        }
+        auto snapshot = std::make_shared<const Watches::Snapshot>(watches.Evaluate(process, thread_index, frame_id, previous.get()));
+        std::lock_guard lock(watchesMutex);
+        watchSnapshot = std::move(snapshot);
+      });
+    }
+  }
+  return watchSnapshot;
+}
+
+bool LLDBDebugger::IsWatchSnapshotCurrent(const Watches::Snapshot& snapshot) {
+  std::lock_guard lock(watchesMutex);
+  return snapshot.stop_id == watchesRequestedStop && snapshot.thread_index == watchesRequestedThread &&
+    snapshot.frame_id == watchesRequestedFrame && snapshot.version == watchesRequestedVersion;
+}
+
+std::shared_ptr<const ValueDiff::Changes> LLDBDebugger::GetValueChanges() {
+  std::lock_guard lock(valueChangesMutex);
+  if (process.IsValid() && process.GetState() == lldb::eStateStopped) {
+    lldb::SBThread thread = process.GetSelectedThread();
+    const uint32_t stop_id = process.GetStopID();
+    const uint32_t thread_index = thread.GetIndexID();
+    const uint32_t frame_id = thread.GetSelectedFrame().GetFrameID();
+    if (stop_id != valueChangesRequestedStop || thread_index != valueChangesRequestedThread || frame_id != valueChangesRequestedFrame) {
+      valueChangesRequestedStop = stop_id;
+      valueChangesRequestedThread = thread_index;
+      valueChangesRequestedFrame = frame_id;
+      stopQueue.Push([this, process = process, stop_id, thread_index, frame_id]() mutable {
+        if (process.GetState() != lldb::eStateStopped) return;
+        auto& previous = previousValues[{thread_index, frame_id}];
+        // Reselecting a frame at the same stop keeps the changes from the earlier stop
+        if (previous.changes && previous.snapshot.stop_id == stop_id) {
+          std::lock_guard lock(valueChangesMutex);
+          valueChanges = previous.changes;
+          return;
+        }
+        auto start = std::chrono::steady_clock::now();
+        ValueDiff::Snapshot current = ValueDiff::Take(process, thread_index, frame_id);
+        const float snapshot_ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+        auto changes = std::make_shared<ValueDiff::Changes>(ValueDiff::Diff(previous.snapshot, current));
+        changes->snapshot_ms = snapshot_ms;
+        previous = PreviousValues{std::move(current), changes};
+        // Threads come and go, don't keep every one that ever stopped
+        if (previousValues.size() > 256)
+          std::erase_if(previousValues, [stop_id](const auto& entry) { return entry.second.snapshot.stop_id != stop_id; });
+        std::lock_guard lock(valueChangesMutex);
+        valueChanges = std::move(changes);
+      });
+    }
+  }
+  return valueChanges;
+}
+
+std::shared_ptr<const Disassembly::View> LLDBDebugger::GetDisassembly() {
+  std::lock_guard lock(disassemblyMutex);
+  if (process.IsValid() && process.GetState() == lldb::eStateStopped) {
+    lldb::SBThread thread = process.GetSelectedThread();
+    const uint32_t stop_id = process.GetStopID();
+    const uint32_t thread_index = thread.GetIndexID();
+    const uint32_t frame_id = thread.GetSelectedFrame().GetFrameID();
+    if (stop_id != disassemblyRequestedStop || thread_index != disassemblyRequestedThread || frame_id != disassemblyRequestedFrame) {
+      disassemblyRequestedStop = stop_id;
+      disassemblyRequestedThread = thread_index;
+      disassemblyRequestedFrame = frame_id;
+      stopQueue.Push([this, process = process, stop_id, thread_index, frame_id]() mutable {
+        if (process.GetState() != lldb::eStateStopped) return;
+        lldb::SBFrame frame = process.GetThreadByIndexID(thread_index).GetFrameAtIndex(frame_id);
+        if (!frame.IsValid()) return;
+        auto view = std::make_shared<Disassembly::View>(Disassembly::View{stop_id, thread_index, frame_id, frame.GetPC(), nullptr});
+        view->listing = disassembly.Get(process.GetTarget(), view->pc);
+        std::lock_guard lock(disassemblyMutex);
+        disassemblyView = std::move(view);
+      });
+    }
+  }
+  return disassemblyView;
+}
+
+std::shared_ptr<const Registers::Snapshot> LLDBDebugger::GetRegisters() {
+  std::lock_guard lock(registersMutex);
+  if (process.IsValid() && process.GetState() == lldb::eStateStopped) {
+    lldb::SBThread thread = process.GetSelectedThread();
+    const uint32_t stop_id = process.GetStopID();
+    const uint32_t thread_index = thread.GetIndexID();
+    const uint32_t frame_id = thread.GetSelectedFrame().GetFrameID();
+    if (stop_id != registersRequestedStop || thread_index != registersRequestedThread || frame_id != registersRequestedFrame) {
+      registersRequestedStop = stop_id;
+      registersRequestedThread = thread_index;
+      registersRequestedFrame = frame_id;
+      stopQueue.Push([this, process = process, stop_id, thread_index, frame_id]() mutable {
+        if (process.GetState() != lldb::eStateStopped) return;
+        lldb::SBFrame frame = process.GetThreadByIndexID(thread_index).GetFrameAtIndex(frame_id);
+        if (!frame.IsValid()) return;
+        auto& previous = previousRegisters[{thread_index, frame_id}];
+        // Reselecting a frame at the same stop keeps the changes from the earlier stop
+        if (previous && previous->stop_id == stop_id) {
+          std::lock_guard lock(registersMutex);
+          registers = previous;
+          return;
+        }
+        auto snapshot = std::make_shared<const Registers::Snapshot>(Registers::Take(frame, stop_id, thread_index, previous.get()));
+        previous = snapshot;
+        // Threads come and go, don't keep every one that ever stopped
+        if (previousRegisters.size() > 256)
+          std::erase_if(previousRegisters, [stop_id](const auto& entry) { return entry.second->stop_id != stop_id; });
+        std::lock_guard lock(registersMutex);
+        registers = std::move(snapshot);
+      });
+    }
+  }
+  return registers;
+}
+
+Disassembly& LLDBDebugger::GetDisassemblyCache() {
+  return disassembly;
+}
+
 void LLDBDebugger::SetTarget(lldb::SBTarget target) {
   debugger.SetSelectedTarget(target);
 }
 
-bool LLDBDebugger::AddBreakpoint(FileHierarchy::TreeNode& node, int id) {
+bool LLDBDebugger::AddBreakpoint(FileHierarchy::TreeNode& node, int id, const BreakpointOptions& options) {
   if (node.lines->empty()) {
     // If we try to add a breakpoint and the file hasnt been loaded yet, we have to load it
     //   so that we have access to its lines
@@ -171,18 +418,71 @@ bool LLDBDebugger::AddBreakpoint(FileHierarchy::TreeNode& node, int id) {
     lldb::SBBreakpoint bp = target.BreakpointCreateByLocation(filename, line_number);
 
     if (bp.IsValid()) {
+        if (!options.condition.empty())
+            bp.SetCondition(options.condition.c_str());
+        bp.SetIgnoreCount(options.ignore_count);
+        bp.SetOneShot(options.one_shot);
         line.bp = true;
         line.bp_id = bp.GetID();
+        line.bp_conditional = !options.condition.empty() || options.ignore_count > 0;
         auto& path = node.path;
         auto real_filename = path.string();
-        id_breakpoint_data[line.bp_id] = {real_filename, line_number};
+        id_breakpoint_data[line.bp_id] = {
+          .path = real_filename,
+          .line_number = line_number,
+          .label = fmt::format("{}: {}:{}", line.bp_id, path.filename().string(), line_number),
+        };
         Logger::Info("Set breakpoint at {} on line {}", filename, line_number);
+        if (!options.condition.empty())
+            Logger::Info("  Condition: {}", options.condition);
+        if (options.ignore_count > 0)
+            Logger::Info("  Ignore count: {}", options.ignore_count);
+        RefreshBreakpointStats();
         return true;
     }
 
     return false;
 }
 
+std::vector<lldb::SBModule> LLDBDebugger::TakeUnindexedModules(const std::vector<lldb::SBModule>& modules) {
+  std::vector<lldb::SBModule> unindexed;
+  std::lock_guard lock(indexed_modules_mutex);
+  for (const auto& module : modules) {
+    if (!module.IsValid()) continue;
+    char module_path[1024] = {};
+    module.GetFileSpec().GetPath(module_path, sizeof(module_path));
+    if (indexed_modules.insert(module_path).second)
+      unindexed.push_back(module);
+  }
+  return unindexed;
+}
+
+std::future<void> LLDBDebugger::IndexModules(std::vector<lldb::SBModule> modules) {
+  auto indexed = std::make_shared<std::promise<void>>();
+  auto future = indexed->get_future();
+
+  // Compile unit and line table enumeration can parse a lot of debug info, so it
+  //   must hold up neither the UI nor the stop/continue handling
+  moduleIndexQueue.Push([this, modules = std::move(modules), indexed]() mutable {
+    Trace::Scope t("Index Modules", "target");
+    auto unindexed = TakeUnindexedModules(modules);
+    if (!unindexed.empty()) {
+      auto paths = Util::GetModulesSourceFiles(unindexed);
+      if (!paths.empty())
+        eventCallback(Event{.data = Event::AddFiles{.paths = std::move(paths)}});
+    }
+    indexed->set_value();
+  });
+  return future;
+}
+
+std::future<void> LLDBDebugger::IndexTarget(lldb::SBTarget target) {
+  std::vector<lldb::SBModule> modules;
+  for (uint32_t i = 0; i < target.GetNumModules(); i++)
+    modules.push_back(target.GetModuleAtIndex(i));
+  return IndexModules(std::move(modules));
+}
+
 bool LLDBDebugger::RemoveBreakpoint(FileHierarchy::TreeNode& node, int id) {
   if (node.lines->empty()) return false;
     if (id < 0 || id >= static_cast<int>(node.lines->size())) {
@@ -197,14 +497,237 @@ bool LLDBDebugger::RemoveBreakpoint(FileHierarchy::TreeNode& node, int id) {
     auto target = GetTarget();
     if (target.BreakpointDelete(line.bp_id)) {
         line.bp = false;
+        line.bp_conditional = false;
         id_breakpoint_data.erase(line.bp_id);
+        {
+          std::lock_guard lock(breakpointStatsMutex);
+          conditionCost.erase(line.bp_id);
+        }
         line.bp_id = LLDB_INVALID_BREAK_ID;
+        RefreshBreakpointStats();
         return true;
     }
 
     return false;
 }
 
+bool LLDBDebugger::SetBreakpointOptions(FileHierarchy::TreeNode& node, int id, const BreakpointOptions& options) {
+  if (id < 0 || id >= static_cast<int>(node.lines->size())) return false;
+  Line& line = node.lines->at(id);
+  if (!line.bp) return false;
+  lldb::SBBreakpoint bp = GetTarget().FindBreakpointByID(line.bp_id);
+  if (!bp.IsValid()) return false;
+
+  const char* previous = bp.GetCondition();
+  if (options.condition != (previous ? previous : "")) {
+    // An empty condition clears it
+    bp.SetCondition(options.condition.c_str());
+    std::lock_guard lock(breakpointStatsMutex);
+    conditionCost.erase(line.bp_id);
+  }
+  bp.SetIgnoreCount(options.ignore_count);
+  bp.SetOneShot(options.one_shot);
+  line.bp_conditional = !options.condition.empty() || options.ignore_count > 0;
+  RefreshBreakpointStats();
+  return true;
+}
+
+LLDBDebugger::BreakpointOptions LLDBDebugger::GetBreakpointOptions(lldb::break_id_t id) {
+  lldb::SBBreakpoint bp = GetTarget().FindBreakpointByID(id);
+  if (!bp.IsValid()) return {};
+  const char* condition = bp.GetCondition();
+  return BreakpointOptions{
+    .condition = condition ? condition : "",
+    .ignore_count = bp.GetIgnoreCount(),
+    .one_shot = bp.IsOneShot(),
+  };
+}
+
+void LLDBDebugger::BeginConditionRun() {
+  // Sample stops resume without a public stop and would count as evaluations
+  if (conditionRun || sampler.IsRunning()) return;
+  auto target = GetTarget();
+  ConditionRun run{.resumed = std::chrono::steady_clock::now(), .stop_id = process.GetStopID(), .conditional = LLDB_INVALID_BREAK_ID, .other_hits = 0, .passed = signals.GetTotalPassed(), .from_breakpoint = stoppedAtBreakpoint};
+  for (uint32_t i = 0; i < target.GetNumBreakpoints(); i++) {
+    lldb::SBBreakpoint bp = target.GetBreakpointAtIndex(i);
+    const char* condition = bp.GetCondition();
+    if (bp.IsEnabled() && condition && *condition) {
+      // With two of them the evaluations can't be told apart
+      if (run.conditional != LLDB_INVALID_BREAK_ID) return;
+      run.conditional = bp.GetID();
+    }
+    else {
+      run.other_hits += bp.GetHitCount();
+    }
+  }
+  if (run.conditional != LLDB_INVALID_BREAK_ID)
+    conditionRun = run;
+}
+
+void LLDBDebugger::EndConditionRun(bool stepped, bool at_breakpoint) {
+  if (!conditionRun) return;
+  const ConditionRun run = *conditionRun;
+  conditionRun.reset();
+  // Stepping stops privately at every instruction or range it steps through
+  if (stepped || sampler.IsRunning()) return;
+
+  const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - run.resumed).count();
+  auto target = GetTarget();
+  uint64_t other_hits = 0;
+  for (uint32_t i = 0; i < target.GetNumBreakpoints(); i++) {
+    lldb::SBBreakpoint bp = target.GetBreakpointAtIndex(i);
+    if (bp.GetID() != run.conditional)
+      other_hits += bp.GetHitCount();
+  }
+  // Signals take one stop, breakpoint hits two. The step over the site we
+  //   resumed from is one more, a final breakpoint stop hasn't stepped over
+  //   its site yet and any other final stop is a single one.
+  //   Breakpoints removed during the run make the counts meaningless, those
+  //   runs are dropped
+  const int64_t stops = (int64_t)(process.GetStopID() - run.stop_id)
+    - (int64_t)(signals.GetTotalPassed() - run.passed)
+    - (run.from_breakpoint ? 1 : 0)
+    + (at_breakpoint ? 1 : -1);
+  const int64_t evaluations = stops / 2 - ((int64_t)other_hits - (int64_t)run.other_hits);
+  if (other_hits < run.other_hits || evaluations <= 0) return;
+
+  std::lock_guard lock(breakpointStatsMutex);
+  auto& cost = conditionCost[run.conditional];
+  cost.seconds += seconds;
+  cost.evaluations += (uint64_t)evaluations;
+}
+
+void LLDBDebugger::RefreshBreakpointStats() {
+  Trace::Scope t("Breakpoint Stats", "lldb");
+  std::lock_guard refresh_lock(breakpointStatsRefreshMutex);
+  using clock = std::chrono::steady_clock;
+  const auto now = clock::now();
+
+  std::shared_ptr<const std::vector<BreakpointStats>> previous;
+  clock::time_point previous_at;
+  {
+    std::lock_guard lock(breakpointStatsMutex);
+    previous = breakpointStats;
+    previous_at = breakpointStatsAt;
+  }
+  std::unordered_map<lldb::break_id_t, const BreakpointStats*> previous_by_id;
+  for (const auto& stats : *previous)
+    previous_by_id[stats.id] = &stats;
+  const float elapsed = std::chrono::duration<float>(now - previous_at).count();
+  auto rate = [&](uint32_t hits, uint32_t previous_hits) {
+    return elapsed > 0.f && hits > previous_hits ? (hits - previous_hits) / elapsed : 0.f;
+  };
+
+  auto target = GetTarget();
+  std::vector<BreakpointStats> stats;
+  bool auto_continue = false;
+  const uint32_t count = target.GetNumBreakpoints();
+  stats.reserve(count);
+  for (uint32_t i = 0; i < count; i++) {
+    lldb::SBBreakpoint bp = target.GetBreakpointAtIndex(i);
+    auto it = previous_by_id.find(bp.GetID());
+    const BreakpointStats* last = it == previous_by_id.end() ? nullptr : it->second;
+
+    auto& entry = stats.emplace_back();
+    entry.id = bp.GetID();
+    entry.hits = bp.GetHitCount();
+    entry.auto_continue = bp.GetAutoContinue();
+    auto_continue |= entry.auto_continue;
+    const char* condition = bp.GetCondition();
+    entry.condition = condition ? condition : "";
+    entry.ignore_count = bp.GetIgnoreCount();
+    entry.one_shot = bp.IsOneShot();
+    entry.condition_ms = -1.f;
+    if (last) {
+      entry.label = last->label;
+      entry.path = last->path;
+      entry.rate = rate(entry.hits, last->hits);
+      entry.first_hit = last->hits == 0 && entry.hits > 0 ? now : last->first_hit;
+      entry.last_hit = entry.hits != last->hits ? now : last->last_hit;
+    }
+    else {
+      entry.rate = 0.f;
+      entry.first_hit = entry.last_hit = entry.hits > 0 ? now : clock::time_point{};
+    }
+
+    const uint32_t location_count = bp.GetNumLocations();
+    entry.locations.reserve(location_count);
+    for (uint32_t j = 0; j < location_count; j++) {
+      lldb::SBBreakpointLocation location = bp.GetLocationAtIndex(j);
+      auto& location_stats = entry.locations.emplace_back();
+      location_stats.id = location.GetID();
+      location_stats.address = location.GetLoadAddress();
+      location_stats.hits = location.GetHitCount();
+      location_stats.rate = 0.f;
+      const LocationStats* last_location = nullptr;
+      if (last) {
+        for (const auto& l : last->locations)
+          if (l.id == location_stats.id) last_location = &l;
+      }
+      if (last_location) {
+        location_stats.function = last_location->function;
+        location_stats.rate = rate(location_stats.hits, last_location->hits);
+        location_stats.last_hit = location_stats.hits != last_location->hits ? now : last_location->last_hit;
+        continue;
+      }
+      location_stats.last_hit = location_stats.hits > 0 ? now : clock::time_point{};
+      // First time this location is seen, resolve its names once
+      lldb::SBAddress address = location.GetAddress();
+      lldb::SBFunction function = address.GetFunction();
+      lldb::SBSymbol symbol = address.GetSymbol();
+      const char* name = function.IsValid() ? function.GetDisplayName() : symbol.IsValid() ? symbol.GetDisplayName() : nullptr;
+      location_stats.function = name ? name : fmt::format("0x{:x}", location_stats.address);
+      if (entry.label.empty()) {
+        lldb::SBLineEntry line_entry = address.GetLineEntry();
+        if (line_entry.IsValid() && line_entry.GetFileSpec().GetFilename()) {
+          auto file_spec = line_entry.GetFileSpec();
+          entry.path = std::filesystem::path(file_spec.GetDirectory() ? file_spec.GetDirectory() : "") / file_spec.GetFilename();
+          entry.label = fmt::format("{}: {}:{}", entry.id, file_spec.GetFilename(), line_entry.GetLine());
+        }
+      }
+    }
+    if (entry.label.empty())
+      entry.label = fmt::format("{}: (unresolved)", entry.id);
+  }
+
+  std::lock_guard lock(breakpointStatsMutex);
+  for (auto& entry : stats) {
+    // A handful of evaluations is mostly resume latency
+    constexpr uint64_t MinEvaluations = 16;
+    auto cost = conditionCost.find(entry.id);
+    if (cost != conditionCost.end() && cost->second.evaluations >= MinEvaluations)
+      entry.condition_ms = (float)(cost->second.seconds * 1000.0 / cost->second.evaluations);
+  }
+  breakpointStats = std::make_shared<const std::vector<BreakpointStats>>(std::move(stats));
+  breakpointStatsAt = now;
+  anyAutoContinue = auto_continue;
+}
+
+std::shared_ptr<const std::vector<LLDBDebugger::BreakpointStats>> LLDBDebugger::GetBreakpointStats() {
+  std::lock_guard lock(breakpointStatsMutex);
+  return breakpointStats;
+}
+
+void LLDBDebugger::RequestBreakpointStats() {
+  {
+    std::lock_guard lock(breakpointStatsMutex);
+    if (!anyAutoContinue || std::chrono::steady_clock::now() - breakpointStatsAt < std::chrono::milliseconds(500))
+      return;
+  }
+  if (breakpointStatsQueued.exchange(true)) return;
+  stopQueue.Push([this]() {
+    RefreshBreakpointStats();
+    breakpointStatsQueued = false;
+  });
+}
+
+void LLDBDebugger::SetBreakpointAutoContinue(lldb::break_id_t id, bool auto_continue) {
+  lldb::SBBreakpoint bp = GetTarget().FindBreakpointByID(id);
+  if (!bp.IsValid()) return;
+  bp.SetAutoContinue(auto_continue);
+  RefreshBreakpointStats();
+}
+
 void LLDBDebugger::HitBreakpoint(lldb::break_id_t b_id) {
   auto it = id_breakpoint_data.find(b_id);
   if (it == id_breakpoint_data.end())
@@ -220,7 +743,7 @@ void LLDBDebugger::SetActiveLine(BreakpointData data) {
   eventCallback(Event{.data = Event::SwitchToFile{.filepath=active_line->path}});
 }
 
-bool LLDBDebugger::IsActiveFile(const std::string& path) {
+bool LLDBDebugger::IsActiveFile(const std::filesystem::path& path) {
   return active_line.has_value() && active_line->path == path;
 }
 
@@ -282,6 +805,7 @@ void LLDBDebugger::Next() {
 
 
 LLDBDebugger::ExecResult LLDBDebugger::ExecCommand(const std::string& command, FileHierarchy& fh) {
+  Trace::Scope t("ExecCommand", "command");
   auto parsed_command = commandParser.Parse(command);
   switch (parsed_command.type) {
     case LLDB_CommandParser::ParsedCommandType::EMPTY:
@@ -296,7 +820,7 @@ LLDBDebugger::ExecResult LLDBDebugger::ExecCommand(const std::string& command, F
         }
         else {
           eventCallback(Event{.data = Event::LoadFile{.node = node}});
-          if (AddBreakpoint(*node, bpfileline.line)) {
+          if (AddBreakpoint(*node, bpfileline.line, bpfileline.options)) {
             Logger::Info("Breakpoint in file '{}' line {}", bpfileline.file, bpfileline.line);
           }
           else {
@@ -343,7 +867,7 @@ LLDBDebugger::ExecResult LLDBDebugger::ExecCommand(const std::string& command, F
           auto path = std::filesystem::path(fs.GetDirectory()) / fs.GetFilename();
           if (auto node = fh.GetElementByLocalPath(path)) {
             eventCallback(Event{.data = Event::LoadFile{.node = node}});
-            if (AddBreakpoint(*node, lineno)) {
+            if (AddBreakpoint(*node, lineno, bpsymbol.options)) {
               Logger::Info("Break on symbol {} in {}", bpsymbol.symbol, fs.GetFilename());
             }
             else {
@@ -357,6 +881,24 @@ LLDBDebugger::ExecResult LLDBDebugger::ExecCommand(const std::string& command, F
         }
         break;
       }
+    case LLDB_CommandParser::ParsedCommandType::TRACEPOINT_FILE_LINE:
+      {
+        auto tpfileline = std::get<LLDB_CommandParser::TPFileLine>(parsed_command.command);
+        auto node = fh.GetElementByFilename(tpfileline.file);
+        if (!node) {
+          Logger::Err("File '{}' does not exist in target", tpfileline.file);
+          break;
+        }
+        if (tracepoints.Add(GetTarget(), node->name, tpfileline.line, tpfileline.message) != LLDB_INVALID_BREAK_ID)
+          RefreshBreakpointStats();
+        break;
+      }
+    case LLDB_CommandParser::ParsedCommandType::SIGNAL_HANDLE:
+      {
+        auto handle = std::get<LLDB_CommandParser::SignalHandle>(parsed_command.command);
+        signals.Set(GetProcess(), handle.signal, handle.pass, handle.stop, handle.notify);
+        break;
+      }
     case LLDB_CommandParser::ParsedCommandType::RUN:
       {
         LaunchTarget(std::nullopt);
@@ -415,22 +957,72 @@ void LLDBDebugger::DumpToStd(TempRedirect &redirect, std::ostream &out, size_t&
     out.flush();
 }
 
+void LLDBDebugger::HandleTargetEvent(const lldb::SBEvent& event) {
+  using namespace lldb;
+  Trace::Scope t("Target Event", "lldb");
+  const uint32_t type = event.GetType();
+  const uint32_t module_count = SBTarget::GetNumModulesFromEvent(event);
+
+  if (type & SBTarget::eBroadcastBitModulesLoaded) {
+    std::vector<SBModule> modules;
+    modules.reserve(module_count);
+    for (uint32_t i = 0; i < module_count; i++)
+      modules.push_back(SBTarget::GetModuleAtIndexFromEvent(i, event));
+    Logger::Info("{} module(s) loaded", module_count);
+
+    IndexModules(std::move(modules));
+  }
+  else if (type & SBTarget::eBroadcastBitModulesUnloaded) {
+    // Already indexed sources stay browsable, forgetting the module only lets
+    //   it be indexed again if it is reloaded
+    std::lock_guard lock(indexed_modules_mutex);
+    for (uint32_t i = 0; i < module_count; i++) {
+      char module_path[1024] = {};
+      SBTarget::GetModuleAtIndexFromEvent(i, event).GetFileSpec().GetPath(module_path, sizeof(module_path));
+      indexed_modules.erase(module_path);
+      Logger::Info("Module unloaded: {}", module_path);
+    }
+  }
+}
+
 void LLDBDebugger::LLDBEventThread() {
   using namespace lldb;
   SBEvent event;
   bool running = true;
+  Trace::SetThreadName("LLDB Events");
   while (running) {
     DumpToStd(out_redirect, std::cout, out_offset);
     DumpToStd(err_redirect, std::cerr, err_offset);
     if (listener.WaitForEvent(1, event)) {
-      if (SBProcess::EventIsProcessEvent(event)) {
-        Logger::Info("Event name: {}", event.GetBroadcaster().GetName());
+      Trace::Scope t("LLDB Event", "lldb");
+      if (SBTarget::EventIsTargetEvent(event)) {
+        HandleTargetEvent(event);
+      }
+      else if (SBProcess::EventIsProcessEvent(event)) {
         StateType state = SBProcess::GetStateFromEvent(event);
+        // Sample stops are resumed on the spot, the rest of the app never sees them
+        if (state == eStateStopped && sampler.TryTakeSample(event))
+          continue;
+        // LLDB already resumed from this stop, e.g. a signal that passes without
+        //   stopping. Only counted, it must not look like a stop to anything else
+        if (state == eStateStopped && SBProcess::GetRestartedFromEvent(event)) {
+          signals.CountRestart(event);
+          continue;
+        }
+        // At sampling rates the running events would drown the log
+        const bool quiet = sampler.IsRunning() && state == eStateRunning;
+        if (!quiet)
+          Logger::Info("Event name: {}", event.GetBroadcaster().GetName());
         switch (state) {
           case eStateStopped: {
-              Logger::Info("Target stopped");
+              StopLatency::MarkStopped();
+              Trace::Scope t("Stop Processing", "lldb");
               SBProcess process = SBProcess::GetProcessFromEvent(event);
               const uint32_t thread_count = process.GetNumThreads();
+              bool stepped = false;
+              bool at_breakpoint = false;
+              const tid_t selected_tid = process.GetSelectedThread().GetThreadID();
+              Logger::Info("Target stopped ({} threads)", thread_count);
 
               for (uint32_t i = 0; i < thread_count; ++i) {
                   SBThread thread = process.GetThreadAtIndex(i);
@@ -438,9 +1030,17 @@ void LLDBDebugger::LLDBEventThread() {
                       continue;
                   }
 
-                  Logger::Info("Thread ID: {} | Stop Reason: {}", thread.GetThreadID(), (uint64_t)thread.GetStopReason());
-
+                  // Only the threads that caused the stop matter here. With thousands of
+                  //   threads the rest would flood the log, the Stacks view covers them
                   StopReason reason = thread.GetStopReason();
+                  stepped |= reason == eStopReasonPlanComplete || reason == eStopReasonTrace;
+                  at_breakpoint |= reason == eStopReasonBreakpoint;
+                  if ((reason == eStopReasonNone || reason == eStopReasonInvalid) && thread.GetThreadID() != selected_tid) {
+                      continue;
+                  }
+
+                  Logger::Info("Thread ID: {} | Stop Reason: {}", thread.GetThreadID(), (uint64_t)reason);
+
                   const size_t desc_count = thread.GetStopReasonDataCount();
                   std::string reason_str;
 
@@ -454,9 +1054,11 @@ void LLDBDebugger::LLDBEventThread() {
                       case eStopReasonWatchpoint:
                           reason_str = "Watchpoint";
                           break;
-                      case eStopReasonSignal:
-                          reason_str = "Signal";
+                      case eStopReasonSignal: {
+                          const char* name = process.GetUnixSignals().GetSignalAsCString((int32_t)thread.GetStopReasonDataAtIndex(0));
+                          reason_str = fmt::format("Signal {}", name ? name : "?");
                           break;
+                      }
                       case eStopReasonException:
                           reason_str = "Exception";
                           break;
@@ -492,16 +1094,26 @@ void LLDBDebugger::LLDBEventThread() {
                       }
                   }
               }
+              StopLatency::MarkHandedOff();
+              // After the hand off, so it never delays showing the stop
+              EndConditionRun(stepped, at_breakpoint);
+              stoppedAtBreakpoint = at_breakpoint;
+              RefreshBreakpointStats();
+              UpdateMemorySnapshots();
               break;
           }
           case eStateExited: {
             Logger::Info("Target exited");
+            sampler.Stop();
+            resourceMonitor.Stop();
             running = false;
             goto exit;
           }
           case eStateRunning:
             active_line.reset();
-            Logger::Info("Target running");
+            BeginConditionRun();
+            if (!quiet)
+              Logger::Info("Target running");
             break;
           case eStateCrashed:
             Logger::Info("Target crashed");
@@ -9,8 +9,28 @@ struct FileContext;
 #include <thread>
 #include <variant>
 #include <fmt/core.h>
+#include <unordered_set>
+#include <mutex>
+#include <future>
+#include <atomic>
+#include <chrono>
+#include <map>
 #include "LLDBCommandParser.hpp"
 #include "TempRedirect.hpp"
+#include "TaskQueue.hpp"
+#include "Sampler.hpp"
+#include "Stacks.hpp"
+#include "ThreadMonitor.hpp"
+#include "ResourceMonitor.hpp"
+#include "Tracepoints.hpp"
+#include "Exceptions.hpp"
+#include "Signals.hpp"
+#include "Watches.hpp"
+#include "ValueDiff.hpp"
+#include "MemoryCache.hpp"
+#include "MemorySnapshots.hpp"
+#include "Disassembly.hpp"
+#include "Registers.hpp"
 
 class LLDBDebugger {
   friend class Window;
@@ -28,7 +48,10 @@ class LLDBDebugger {
       struct SwitchToFile {
         std::filesystem::path filepath;
       };
-      std::variant<Continue, StepOver, StepInto, LoadFile, IO, SwitchToFile> data;
+      struct AddFiles {
+        std::vector<std::filesystem::path> paths;
+      };
+      std::variant<Continue, StepOver, StepInto, LoadFile, IO, SwitchToFile, AddFiles> data;
     };
   public:
     enum class ExecResultStatus {
@@ -54,7 +77,38 @@ class LLDBDebugger {
       std::filesystem::path path;
       // std::string filename;
       int line_number;
+      // Display label, built once when the breakpoint is added
+      std::string label;
+    };
+    struct LocationStats {
+      lldb::break_id_t id;
+      lldb::addr_t address;
+      std::string function;
+      uint32_t hits;
+      float rate; // hits/s since the previous refresh
+      std::chrono::steady_clock::time_point last_hit;
     };
+    struct BreakpointStats {
+      lldb::break_id_t id;
+      std::string label;
+      std::filesystem::path path;
+      uint32_t hits;
+      float rate;
+      // Hit times are only known to the refresh that noticed the count change
+      std::chrono::steady_clock::time_point first_hit;
+      std::chrono::steady_clock::time_point last_hit;
+      bool auto_continue;
+      std::string condition;
+      uint32_t ignore_count;
+      bool one_shot;
+      // Running time per evaluation of the condition, over the runs where it
+      //   was the only conditional breakpoint. An estimate, the evaluations
+      //   are inferred from stop IDs and the process' own work between hits
+      //   is included. Negative until enough were seen
+      float condition_ms;
+      std::vector<LocationStats> locations;
+    };
+    using BreakpointOptions = LLDB_CommandParser::BPOptions;
   public:
     LLDBDebugger();
     ~LLDBDebugger();
@@ -64,17 +118,70 @@ class LLDBDebugger {
     lldb::SBDebugger& GetDebugger(); 
     lldb::SBTarget GetTarget();
     lldb::SBProcess GetProcess();
+    // Turns on LLDB's "lldb api" log, which has a line for every SB call, and
+    //   counts the UI thread's ones in the Profiler. Costs a formatted log
+    //   line per call while on
+    void SetCountSBCalls(bool on);
+    Sampler& GetSampler();
+    ThreadMonitor& GetThreadMonitor();
+    ResourceMonitor& GetResourceMonitor();
+    Tracepoints& GetTracepoints();
+    Exceptions& GetExceptions();
+    Signals& GetSignals();
+    // Latest stack snapshot, which may be from an earlier stop. A new one is
+    //   collected on the stop queue the first time it's asked for after a stop
+    std::shared_ptr<const Stacks::Snapshot> GetStacks();
+    Watches& GetWatches();
+    MemoryCache& GetMemoryCache();
+    MemorySnapshots& GetMemorySnapshots();
+    // Reads the pinned ranges on the stop queue, a no-op without pins
+    void UpdateMemorySnapshots();
+    // Watch results for the latest stop, evaluated as a batch on the stop queue
+    //   once per stop and whenever the list changes. Null until the first batch
+    std::shared_ptr<const Watches::Snapshot> GetWatchSnapshot();
+    // Whether the snapshot is for the stop, frame and list last asked for
+    bool IsWatchSnapshotCurrent(const Watches::Snapshot& snapshot);
+    // Locals of the selected frame that changed since the
+    //   previous stop. Diffed on the stop queue the first time it's asked for
+    //   after a stop or a frame change, against the snapshot of the same
+    //   thread and frame from the last stop that asked
+    std::shared_ptr<const ValueDiff::Changes> GetValueChanges();
+    // The function around the selected frame's pc. Looked up on the stop
+    //   queue whenever the stop or the selected frame changes, functions
+    //   already disassembled come straight from the cache
+    std::shared_ptr<const Disassembly::View> GetDisassembly();
+    Disassembly& GetDisassemblyCache();
+    // The selected frame's registers, read on the stop queue once per stop
+    //   and selected frame. Changes are against the last read of the same
+    //   thread and frame at an earlier stop
+    std::shared_ptr<const Registers::Snapshot> GetRegisters();
     void SetTarget(lldb::SBTarget target);
 
-    bool AddBreakpoint(FileHierarchy::TreeNode&, int id);
+    bool AddBreakpoint(FileHierarchy::TreeNode&, int id, const BreakpointOptions& options = {});
     bool RemoveBreakpoint(FileHierarchy::TreeNode&, int id);
+    // Conditions are evaluated by LLDB when the breakpoint is hit, a false
+    //   condition or a hit under the ignore count resumes without a public stop
+    bool SetBreakpointOptions(FileHierarchy::TreeNode&, int id, const BreakpointOptions& options);
+    BreakpointOptions GetBreakpointOptions(lldb::break_id_t id);
+
+    // Hit counts are gathered once per stop. Auto-continue breakpoints never
+    //   stop, so while one exists RequestBreakpointStats() also refreshes them
+    //   on the stop queue, at most twice a second
+    std::shared_ptr<const std::vector<BreakpointStats>> GetBreakpointStats();
+    void RequestBreakpointStats();
+    void SetBreakpointAutoContinue(lldb::break_id_t id, bool auto_continue);
+
+    // Enumerates the source files of modules not indexed yet on the index queue
+    //   and posts them as an AddFiles event. The future is ready once it's posted
+    std::future<void> IndexModules(std::vector<lldb::SBModule> modules);
+    std::future<void> IndexTarget(lldb::SBTarget target);
   private:
     void HitBreakpoint(lldb::break_id_t b_id);
     void SetActiveLine(BreakpointData bdata);
     bool CanRunCommand();
   public:
     BreakpointData& GetBreakpointData(lldb::break_id_t id);
-    bool IsActiveFile(const std::string& filename);
+    bool IsActiveFile(const std::filesystem::path& path);
     std::filesystem::path GetActiveFile() const;
     bool IsActiveLine(int line_number);
 
@@ -88,10 +195,18 @@ class LLDBDebugger {
     void Next();
 
   private:
+    static void OnLLDBLog(const char* message, void* baton);
     void LLDBEventThread();
+    void HandleTargetEvent(const lldb::SBEvent&);
+    std::vector<lldb::SBModule> TakeUnindexedModules(const std::vector<lldb::SBModule>&);
+    void RefreshBreakpointStats();
+    // Event thread, on resume and on the next public stop
+    void BeginConditionRun();
+    void EndConditionRun(bool stepped, bool at_breakpoint);
 
   private:
     lldb::SBDebugger debugger;
+    bool countingSBCalls = false;
     std::unordered_map<lldb::break_id_t, BreakpointData> id_breakpoint_data;
     std::optional<BreakpointData> active_line;
 
@@ -107,6 +222,93 @@ class LLDBDebugger {
     size_t err_offset = 0;
     void DumpToStd(TempRedirect &redirect, std::ostream &out, size_t& offset);
 
+  private:
+    // Keyed by module path. Guards against re-enumerating a module that is
+    //   reported loaded more than once (e.g. the executable at launch)
+    std::unordered_set<std::string> indexed_modules;
+    std::mutex indexed_modules_mutex;
+    TaskQueue moduleIndexQueue{"Module Index"};
+
+  private:
+    Sampler sampler;
+    ThreadMonitor threadMonitor;
+    ResourceMonitor resourceMonitor;
+    Tracepoints tracepoints;
+    Exceptions exceptions;
+    Signals signals;
+    MemoryCache memoryCache;
+    MemorySnapshots memorySnapshots;
+
+  private:
+    // Work done once per stop, on behalf of views that are open
+    TaskQueue stopQueue{"Stop Snapshots"};
+    std::mutex stacksMutex;
+    std::shared_ptr<const Stacks::Snapshot> stacks;
+    uint32_t stacksRequestedStop = UINT32_MAX;
+    Watches watches;
+    std::mutex watchesMutex;
+    std::shared_ptr<const Watches::Snapshot> watchSnapshot;
+    uint32_t watchesRequestedStop = UINT32_MAX;
+    uint32_t watchesRequestedThread = UINT32_MAX;
+    uint32_t watchesRequestedFrame = UINT32_MAX;
+    uint64_t watchesRequestedVersion = UINT64_MAX;
+    std::mutex valueChangesMutex;
+    std::shared_ptr<const ValueDiff::Changes> valueChanges;
+    uint32_t valueChangesRequestedStop = UINT32_MAX;
+    uint32_t valueChangesRequestedThread = UINT32_MAX;
+    uint32_t valueChangesRequestedFrame = UINT32_MAX;
+    // Last snapshot per thread and frame, with the changes it produced. Only
+    //   touched on the stop queue
+    struct PreviousValues {
+      ValueDiff::Snapshot snapshot;
+      std::shared_ptr<const ValueDiff::Changes> changes;
+    };
+    std::map<std::pair<uint32_t, uint32_t>, PreviousValues> previousValues;
+    Disassembly disassembly;
+    std::mutex disassemblyMutex;
+    std::shared_ptr<const Disassembly::View> disassemblyView;
+    uint32_t disassemblyRequestedStop = UINT32_MAX;
+    uint32_t disassemblyRequestedThread = UINT32_MAX;
+    uint32_t disassemblyRequestedFrame = UINT32_MAX;
+    std::mutex registersMutex;
+    std::shared_ptr<const Registers::Snapshot> registers;
+    uint32_t registersRequestedStop = UINT32_MAX;
+    uint32_t registersRequestedThread = UINT32_MAX;
+    uint32_t registersRequestedFrame = UINT32_MAX;
+    // Last read per thread and frame, only touched on the stop queue
+    std::map<std::pair<uint32_t, uint32_t>, std::shared_ptr<const Registers::Snapshot>> previousRegisters;
+
+  private:
+    // Held across a whole refresh, the UI, event and stop queue threads all
+    //   refresh and each one builds on the previous result
+    std::mutex breakpointStatsRefreshMutex;
+    std::mutex breakpointStatsMutex;
+    std::shared_ptr<const std::vector<BreakpointStats>> breakpointStats = std::make_shared<std::vector<BreakpointStats>>();
+    std::chrono::steady_clock::time_point breakpointStatsAt;
+    bool anyAutoContinue = false;
+    std::atomic<bool> breakpointStatsQueued = false;
+    // Keyed by breakpoint, dropped when the condition changes
+    struct ConditionCost {
+      double seconds = 0.0;
+      uint64_t evaluations = 0;
+    };
+    std::unordered_map<lldb::break_id_t, ConditionCost> conditionCost;
+    // A run from resume to the next public stop. Every stop LLDB takes bumps
+    //   the stop ID, and a breakpoint hit that continues takes two: the trap
+    //   and the step over the site on resume. What isn't other breakpoints'
+    //   hits or passed signals are the lone conditional breakpoint's
+    //   evaluations. Event thread only
+    struct ConditionRun {
+      std::chrono::steady_clock::time_point resumed;
+      uint32_t stop_id;
+      lldb::break_id_t conditional;
+      uint64_t other_hits;
+      uint64_t passed;
+      bool from_breakpoint; // resuming steps over the site first
+    };
+    std::optional<ConditionRun> conditionRun;
+    bool stoppedAtBreakpoint = false;
+
   protected:
     std::function<void(const Event&)> eventCallback;
 
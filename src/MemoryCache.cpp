@@ -0,0 +1,109 @@
+#include "MemoryCache.hpp"
+#include "Trace.hpp"
+
+MemoryCache::MemoryCache() {}
+
+MemoryCache::~MemoryCache() {
+  Stop();
+}
+
+void MemoryCache::Stop() {
+  prefetchQueue.Stop();
+}
+
+bool MemoryCache::Validate(lldb::SBProcess& process) {
+  if (!process.IsValid() || process.GetState() != lldb::eStateStopped) return false;
+  const uint32_t stop_id = process.GetStopID();
+  if (stop_id != stopId) {
+    lru.clear();
+    pages.clear();
+    pending.clear();
+    stopId = stop_id;
+  }
+  return true;
+}
+
+std::shared_ptr<const MemoryCache::Page> MemoryCache::Find(lldb::addr_t page) {
+  auto it = pages.find(page);
+  if (it == pages.end()) return nullptr;
+  lru.splice(lru.begin(), lru, it->second);
+  return *it->second;
+}
+
+void MemoryCache::Insert(std::shared_ptr<const Page> page) {
+  if (pages.contains(page->address)) return;
+  lru.push_front(page);
+  pages[page->address] = lru.begin();
+  while (lru.size() > Capacity) {
+    pages.erase(lru.back()->address);
+    lru.pop_back();
+  }
+}
+
+std::shared_ptr<const MemoryCache::Page> MemoryCache::Read(lldb::SBProcess& process, lldb::addr_t page) {
+  Trace::Scope t("Read Page", "memory");
+  auto result = std::make_shared<Page>();
+  result->address = page;
+  lldb::SBError error;
+  const size_t read = process.ReadMemory(page, result->bytes.data(), PageSize, error);
+  result->readable = error.Fail() ? 0 : (uint32_t)read;
+  return result;
+}
+
+std::shared_ptr<const MemoryCache::Page> MemoryCache::GetPage(lldb::SBProcess process, lldb::addr_t address) {
+  const lldb::addr_t page = address & ~(PageSize - 1);
+  {
+    std::lock_guard lock(mutex);
+    if (!Validate(process)) return nullptr;
+    if (auto cached = Find(page)) {
+      hits++;
+      return cached;
+    }
+  }
+  // Read without the lock, the prefetcher may be reading the neighbours
+  auto read = Read(process, page);
+  std::lock_guard lock(mutex);
+  reads++;
+  if (Validate(process)) Insert(read);
+  return read;
+}
+
+void MemoryCache::Prefetch(lldb::SBProcess process, lldb::addr_t first, lldb::addr_t last) {
+  std::lock_guard lock(mutex);
+  if (!Validate(process)) return;
+  const uint32_t stop_id = stopId;
+  for (lldb::addr_t page = first & ~(PageSize - 1); page < last; page += PageSize) {
+    if (pages.contains(page) || !pending.insert(page).second) continue;
+    prefetchQueue.Push([this, process, page, stop_id]() mutable {
+      {
+        std::lock_guard lock(mutex);
+        if (stopId != stop_id || pages.contains(page)) {
+          pending.erase(page);
+          return;
+        }
+      }
+      // Resumed since it was queued, whatever is read now is already stale
+      if (process.GetState() != lldb::eStateStopped || process.GetStopID() != stop_id) return;
+      auto read = Read(process, page);
+      std::lock_guard lock(mutex);
+      pending.erase(page);
+      reads++;
+      if (stopId == stop_id) Insert(read);
+    });
+    // Stops at the top of the address space
+    if (page + PageSize < page) break;
+  }
+}
+
+uint64_t MemoryCache::GetReads() const {
+  return reads;
+}
+
+uint64_t MemoryCache::GetHits() const {
+  return hits;
+}
+
+size_t MemoryCache::GetSize() {
+  std::lock_guard lock(mutex);
+  return lru.size();
+}
@@ -0,0 +1,63 @@
+#ifndef MEMORY_CACHE_HPP
+#define MEMORY_CACHE_HPP
+#include <lldb/API/LLDB.h>
+#include "TaskQueue.hpp"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+
+// Inferior memory in 4 KiB pages, for the memory window. Pages are read on
+//   demand, neighbours are prefetched on a background thread, and the least
+//   recently used ones are dropped past Capacity. Everything is thrown away
+//   once the process has run, memory can't be trusted after a resume
+class MemoryCache {
+  public:
+    static constexpr uint64_t PageSize = 4096;
+    static constexpr size_t Capacity = 512; // 2 MiB
+
+    struct Page {
+      lldb::addr_t address;
+      // Bytes past a failed or short read are unreadable
+      uint32_t readable;
+      std::array<uint8_t, PageSize> bytes;
+    };
+
+  public:
+    MemoryCache();
+    ~MemoryCache();
+    void Stop();
+
+    // Reads the page on a miss. Null while the process isn't stopped
+    std::shared_ptr<const Page> GetPage(lldb::SBProcess process, lldb::addr_t address);
+    // Queues pages in [first, last) that aren't cached yet
+    void Prefetch(lldb::SBProcess process, lldb::addr_t first, lldb::addr_t last);
+
+    uint64_t GetReads() const;
+    uint64_t GetHits() const;
+    size_t GetSize();
+
+  private:
+    // Called with the mutex held
+    bool Validate(lldb::SBProcess& process);
+    std::shared_ptr<const Page> Find(lldb::addr_t page);
+    void Insert(std::shared_ptr<const Page> page);
+    static std::shared_ptr<const Page> Read(lldb::SBProcess& process, lldb::addr_t page);
+
+  private:
+    std::mutex mutex;
+    uint32_t stopId = UINT32_MAX;
+    // Most recently used first
+    std::list<std::shared_ptr<const Page>> lru;
+    std::unordered_map<lldb::addr_t, std::list<std::shared_ptr<const Page>>::iterator> pages;
+    std::unordered_set<lldb::addr_t> pending;
+    std::atomic<uint64_t> reads = 0;
+    std::atomic<uint64_t> hits = 0;
+    TaskQueue prefetchQueue{"Memory Prefetch"};
+};
+
+#endif
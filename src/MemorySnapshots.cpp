@@ -0,0 +1,180 @@
+#include "MemorySnapshots.hpp"
+#include "Trace.hpp"
+#include "Logger.hpp"
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstring>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MEMORY_SNAPSHOTS_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace {
+  // Bounds a single ReadMemory, an unreadable chunk doesn't fail the rest
+  constexpr uint64_t ReadChunk = 1 << 20;
+
+  void AddRange(std::vector<MemorySnapshots::Range>& ranges, uint64_t offset, uint64_t size) {
+    if (!ranges.empty() && ranges.back().offset + ranges.back().size == offset)
+      ranges.back().size += size;
+    else
+      ranges.push_back({offset, size});
+  }
+
+  // Bit i set when byte i of the 64 byte block differs
+  uint64_t DifferMask(const uint8_t* a, const uint8_t* b) {
+#ifdef MEMORY_SNAPSHOTS_SSE2
+    uint64_t mask = 0;
+    for (int i = 0; i < 4; i++) {
+      const __m128i eq = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(a + i * 16)), _mm_loadu_si128((const __m128i*)(b + i * 16)));
+      mask |= (uint64_t)(uint16_t)~_mm_movemask_epi8(eq) << (i * 16);
+    }
+    return mask;
+#else
+    uint64_t mask = 0;
+    for (int i = 0; i < 64; i++)
+      mask |= (uint64_t)(a[i] != b[i]) << i;
+    return mask;
+#endif
+  }
+
+  // Cheap all-equal test for the common case, one branch per 64 bytes
+  bool Equal64(const uint8_t* a, const uint8_t* b) {
+#ifdef MEMORY_SNAPSHOTS_SSE2
+    __m128i diff = _mm_setzero_si128();
+    for (int i = 0; i < 4; i++)
+      diff = _mm_or_si128(diff, _mm_xor_si128(_mm_loadu_si128((const __m128i*)(a + i * 16)), _mm_loadu_si128((const __m128i*)(b + i * 16))));
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(diff, _mm_setzero_si128())) == 0xffff;
+#else
+    return memcmp(a, b, 64) == 0;
+#endif
+  }
+}
+
+bool MemorySnapshots::Delta::Intersects(uint64_t offset, uint64_t size) const {
+  // First range ending past offset
+  auto it = std::upper_bound(ranges.begin(), ranges.end(), offset, [](uint64_t o, const Range& r) { return o < r.offset + r.size; });
+  return it != ranges.end() && it->offset < offset + size;
+}
+
+std::vector<MemorySnapshots::Range> MemorySnapshots::Diff(const uint8_t* a, const uint8_t* b, uint64_t size) {
+  std::vector<Range> ranges;
+  uint64_t offset = 0;
+  for (; offset + 64 <= size; offset += 64) {
+    if (Equal64(a + offset, b + offset)) continue;
+    uint64_t mask = DifferMask(a + offset, b + offset);
+    // Runs of set bits become ranges
+    while (mask) {
+      const int start = std::countr_zero(mask);
+      const int length = std::countr_one(mask >> start);
+      AddRange(ranges, offset + start, length);
+      mask = length + start >= 64 ? 0 : mask & (~0ull << (start + length));
+    }
+  }
+  for (; offset < size; offset++)
+    if (a[offset] != b[offset])
+      AddRange(ranges, offset, 1);
+  return ranges;
+}
+
+uint32_t MemorySnapshots::Add(lldb::addr_t address, uint64_t size) {
+  if (size == 0 || size > MaxSize) return 0;
+  auto state = std::make_shared<State>();
+  std::lock_guard lock(mutex);
+  state->pin.id = nextId++;
+  state->pin.address = address;
+  state->pin.size = size;
+  pins.push_back(std::move(state));
+  return pins.back()->pin.id;
+}
+
+void MemorySnapshots::Remove(uint32_t id) {
+  std::lock_guard lock(mutex);
+  std::erase_if(pins, [id](const auto& state) { return state->pin.id == id; });
+}
+
+bool MemorySnapshots::HasPins() {
+  std::lock_guard lock(mutex);
+  return !pins.empty();
+}
+
+std::vector<MemorySnapshots::Pin> MemorySnapshots::GetPins() {
+  std::lock_guard lock(mutex);
+  std::vector<Pin> out;
+  out.reserve(pins.size());
+  for (const auto& state : pins)
+    out.push_back(state->pin);
+  return out;
+}
+
+void MemorySnapshots::Update(lldb::SBProcess process) {
+  Trace::Scope t("Memory Snapshots", "diff");
+  std::vector<std::shared_ptr<State>> states;
+  {
+    std::lock_guard lock(mutex);
+    states = pins;
+  }
+  const uint32_t stop_id = process.GetStopID();
+  std::vector<uint8_t> chunk;
+  for (auto& state : states) {
+    Pin& pin = state->pin;
+    if (pin.first_stop == stop_id) continue;
+    if (!pin.deltas.empty() && pin.deltas.back()->stop_id == stop_id) continue;
+
+    // The first read goes straight into current, later ones are diffed
+    //   against it chunk by chunk and then copied over it. Unreadable bytes
+    //   keep their previous value so they never show as changes
+    const bool first = pin.first_stop == UINT32_MAX;
+    if (first)
+      state->current.resize(pin.size);
+    else
+      chunk.resize(std::min<uint64_t>(ReadChunk, pin.size));
+    auto delta = std::make_shared<Delta>();
+    delta->stop_id = stop_id;
+    float read_ms = 0.f, diff_ms = 0.f;
+    for (uint64_t offset = 0; offset < pin.size; offset += ReadChunk) {
+      const uint64_t size = std::min<uint64_t>(ReadChunk, pin.size - offset);
+      uint8_t* current = state->current.data() + offset;
+      uint8_t* target = first ? current : chunk.data();
+      auto start = std::chrono::steady_clock::now();
+      lldb::SBError error;
+      const size_t read = process.ReadMemory(pin.address + offset, target, size, error);
+      if (read < size) {
+        delta->unreadable += size - read;
+        if (first)
+          memset(target + read, 0, size - read);
+        else
+          memcpy(target + read, current + read, size - read);
+      }
+      auto read_end = std::chrono::steady_clock::now();
+      read_ms += std::chrono::duration<float, std::milli>(read_end - start).count();
+      if (first) continue;
+
+      for (const Range& range : Diff(current, target, size)) {
+        AddRange(delta->ranges, offset + range.offset, range.size);
+        delta->bytes.insert(delta->bytes.end(), target + range.offset, target + range.offset + range.size);
+        memcpy(current + range.offset, target + range.offset, range.size);
+      }
+      diff_ms += std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - read_end).count();
+    }
+
+    std::lock_guard lock(mutex);
+    pin.stops++;
+    if (first) {
+      pin.first_stop = stop_id;
+      pin.resident_bytes = pin.size;
+      if (delta->unreadable)
+        Logger::Warn("Memory pin {}: {} of {} bytes unreadable", pin.id, delta->unreadable, pin.size);
+      continue;
+    }
+    delta->read_ms = read_ms;
+    delta->diff_ms = diff_ms;
+    pin.resident_bytes += delta->bytes.size() + delta->ranges.size() * sizeof(Range);
+    pin.deltas.push_back(std::move(delta));
+    if (pin.deltas.size() > MaxHistory) {
+      const Delta& oldest = *pin.deltas.front();
+      pin.resident_bytes -= oldest.bytes.size() + oldest.ranges.size() * sizeof(Range);
+      pin.deltas.erase(pin.deltas.begin());
+    }
+  }
+}
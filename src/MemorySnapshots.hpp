@@ -0,0 +1,68 @@
+#ifndef MEMORY_SNAPSHOTS_HPP
+#define MEMORY_SNAPSHOTS_HPP
+#include <lldb/API/LLDB.h>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Pinned address ranges, read at every stop and diffed against the previous
+//   read to catch unexpected writes. A pin keeps one copy of the range as of
+//   the last stop and only the changed bytes of each stop before it, the
+//   newest MaxHistory of them. Reads and diffs go a chunk at a time, so no
+//   second copy of the range is ever needed
+class MemorySnapshots {
+  public:
+    static constexpr uint64_t MaxSize = 256ull << 20;
+    static constexpr size_t MaxHistory = 64;
+
+    struct Range {
+      uint64_t offset; // from the pinned address
+      uint64_t size;
+    };
+    struct Delta {
+      uint32_t stop_id;
+      std::vector<Range> ranges; // sorted, never adjacent
+      std::vector<uint8_t> bytes; // new contents of the ranges, back to back
+      uint64_t unreadable = 0;
+      float read_ms = 0.f;
+      float diff_ms = 0.f;
+      bool Intersects(uint64_t offset, uint64_t size) const;
+    };
+    struct Pin {
+      uint32_t id;
+      lldb::addr_t address;
+      uint64_t size;
+      uint32_t first_stop = UINT32_MAX;
+      uint32_t stops = 0;
+      // The current copy and the deltas, everything the pin holds on to
+      uint64_t resident_bytes = 0;
+      // Newest last
+      std::vector<std::shared_ptr<const Delta>> deltas;
+    };
+
+  public:
+    // Returns the pin id, 0 if the range is empty or too large
+    uint32_t Add(lldb::addr_t address, uint64_t size);
+    void Remove(uint32_t id);
+    bool HasPins();
+    std::vector<Pin> GetPins();
+    // Must be called while the process is stopped, once per stop
+    void Update(lldb::SBProcess process);
+
+    // Changed ranges of b against a, both `size` bytes
+    static std::vector<Range> Diff(const uint8_t* a, const uint8_t* b, uint64_t size);
+
+  private:
+    struct State {
+      Pin pin;
+      std::vector<uint8_t> current;
+    };
+
+  private:
+    std::mutex mutex;
+    std::vector<std::shared_ptr<State>> pins;
+    uint32_t nextId = 1;
+};
+
+#endif
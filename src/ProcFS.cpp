@@ -0,0 +1,187 @@
+#include "ProcFS.hpp"
+#include <charconv>
+#include <cstdio>
+#include <utility>
+#ifdef __linux__
+#include <cerrno>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+#include <algorithm>
+#include <atomic>
+
+namespace ProcFS {
+#ifdef __linux__
+  bool IsSupported() { return true; }
+
+  uint64_t TicksPerSecond() {
+    static const uint64_t ticks = sysconf(_SC_CLK_TCK);
+    return ticks;
+  }
+
+  uint64_t PageSize() {
+    static const uint64_t page_size = sysconf(_SC_PAGESIZE);
+    return page_size;
+  }
+
+  namespace {
+    std::atomic<int> keptFds = 0;
+  }
+
+  int FdBudget() {
+    static const int budget = [] {
+      rlimit limit{};
+      if (getrlimit(RLIMIT_NOFILE, &limit) != 0 || limit.rlim_cur == RLIM_INFINITY)
+        return 256;
+      return (int)std::min<rlim_t>(limit.rlim_cur / 4, 1024);
+    }();
+    return budget;
+  }
+
+  File::File(File&& other) noexcept
+    : path(std::move(other.path)), fd(std::exchange(other.fd, -1)) {}
+
+  File& File::operator=(File&& other) noexcept {
+    if (this != &other) {
+      Close();
+      path = std::move(other.path);
+      fd = std::exchange(other.fd, -1);
+    }
+    return *this;
+  }
+
+  File::~File() {
+    Close();
+  }
+
+  void File::Close() {
+    if (fd < 0) return;
+    close(fd);
+    fd = -1;
+    keptFds.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  bool File::Open(std::string _path, bool keep_open) {
+    Close();
+    path = std::move(_path);
+    if (keep_open && keptFds.fetch_add(1, std::memory_order_relaxed) < FdBudget()) {
+      fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+      if (fd >= 0) return true;
+      keptFds.fetch_sub(1, std::memory_order_relaxed);
+      // Out of fds for some other reason: open it per read instead
+      return errno == EMFILE || errno == ENFILE;
+    }
+    if (keep_open)
+      keptFds.fetch_sub(1, std::memory_order_relaxed);
+    return access(path.c_str(), R_OK) == 0;
+  }
+
+  long File::Read(char* buf, size_t size) {
+    if (size == 0) return -1;
+    ssize_t n;
+    if (fd >= 0) {
+      n = pread(fd, buf, size - 1, 0);
+    }
+    else {
+      int temp_fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+      if (temp_fd < 0) return -1;
+      n = read(temp_fd, buf, size - 1);
+      close(temp_fd);
+    }
+    if (n < 0) return -1;
+    buf[n] = '\0';
+    return n;
+  }
+
+  bool ListTasks(int pid, std::vector<int>& tids) {
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/%d/task", pid);
+    DIR* dir = opendir(path);
+    if (!dir) return false;
+    tids.clear();
+    while (dirent* entry = readdir(dir)) {
+      int tid = 0;
+      auto name = std::string_view(entry->d_name);
+      auto [end, ec] = std::from_chars(name.data(), name.data() + name.size(), tid);
+      if (ec == std::errc() && end == name.data() + name.size())
+        tids.push_back(tid);
+    }
+    closedir(dir);
+    return true;
+  }
+
+  int CountOpenFds(int pid) {
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/%d/fd", pid);
+    DIR* dir = opendir(path);
+    if (!dir) return -1;
+    int count = 0;
+    while (dirent* entry = readdir(dir))
+      if (entry->d_name[0] != '.') count++;
+    closedir(dir);
+    return count;
+  }
+#else
+  bool IsSupported() { return false; }
+  uint64_t TicksPerSecond() { return 100; }
+  uint64_t PageSize() { return 4096; }
+  File::File(File&& other) noexcept : path(std::move(other.path)) {}
+  File& File::operator=(File&& other) noexcept { path = std::move(other.path); return *this; }
+  File::~File() {}
+  void File::Close() {}
+  int FdBudget() { return 0; }
+  bool File::Open(std::string _path, bool) { path = std::move(_path); return false; }
+  long File::Read(char*, size_t) { return -1; }
+  bool ListTasks(int, std::vector<int>&) { return false; }
+  int CountOpenFds(int) { return -1; }
+#endif
+
+  bool ParseStat(std::string_view text, Stat& stat) {
+    // comm can hold spaces and parentheses, so it ends at the last ')'
+    auto open = text.find('(');
+    auto close = text.rfind(')');
+    if (open == std::string_view::npos || close == std::string_view::npos || close < open)
+      return false;
+    stat.comm = text.substr(open + 1, close - open - 1);
+
+    // Fields after comm, numbered from state = 3 as in proc(5)
+    const char* p = text.data() + close + 1;
+    const char* end = text.data() + text.size();
+    int field = 3;
+    while (p < end && field <= 39) {
+      while (p < end && *p == ' ') p++;
+      const char* token = p;
+      while (p < end && *p != ' ' && *p != '\n') p++;
+      auto parse = [&](auto& value) { std::from_chars(token, p, value); };
+      switch (field) {
+        case 3:  stat.state = *token; break;
+        case 14: parse(stat.utime); break;
+        case 15: parse(stat.stime); break;
+        case 20: parse(stat.num_threads); break;
+        case 23: parse(stat.vsize); break;
+        case 24: parse(stat.rss_pages); break;
+        case 39: parse(stat.processor); break;
+      }
+      field++;
+    }
+    return field > 15;
+  }
+
+  std::string_view FindField(std::string_view text, std::string_view key) {
+    size_t pos = 0;
+    while (pos < text.size()) {
+      size_t line_end = text.find('\n', pos);
+      if (line_end == std::string_view::npos) line_end = text.size();
+      auto line = text.substr(pos, line_end - pos);
+      if (line.size() > key.size() && line.starts_with(key) && line[key.size()] == ':') {
+        auto value = line.substr(key.size() + 1);
+        auto first = value.find_first_not_of(" \t");
+        return first == std::string_view::npos ? std::string_view{} : value.substr(first);
+      }
+      pos = line_end + 1;
+    }
+    return {};
+  }
+}
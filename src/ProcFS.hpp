@@ -0,0 +1,67 @@
+#ifndef PROC_FS_HPP
+#define PROC_FS_HPP
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Helpers for sampling /proc/<pid> without stopping the process. Linux only,
+//   everything reports failure elsewhere.
+namespace ProcFS {
+  bool IsSupported();
+  uint64_t TicksPerSecond();
+  uint64_t PageSize();
+
+  // Fds all Files may keep open together, a quarter of RLIMIT_NOFILE and at
+  //   most 1024. The rest of the app (LLDB, sources, redirects) needs the others
+  int FdBudget();
+
+  // A /proc file that is re-read from offset 0 on every sample. The fd stays
+  //   open between reads while the budget allows, otherwise the file is
+  //   opened on each read
+  class File {
+    public:
+      File() = default;
+      File(File&&) noexcept;
+      File& operator=(File&&) noexcept;
+      File(const File&) = delete;
+      File& operator=(const File&) = delete;
+      ~File();
+
+      // False if the file doesn't exist (e.g. the thread exited). Files read
+      //   rarely pass keep_open = false and are only opened to read
+      bool Open(std::string path, bool keep_open = true);
+      // Reads up to size - 1 bytes and null terminates, -1 on failure
+      long Read(char* buf, size_t size);
+      bool IsCached() const { return fd >= 0; }
+
+    private:
+      void Close();
+
+    private:
+      std::string path;
+      int fd = -1;
+  };
+
+  struct Stat {
+    std::string_view comm;
+    char state = '?';
+    uint64_t utime = 0;
+    uint64_t stime = 0;
+    int64_t num_threads = 0;
+    uint64_t vsize = 0;
+    int64_t rss_pages = 0;
+    int processor = -1;
+  };
+  // Parses /proc/<pid>[/task/<tid>]/stat, comm points into the buffer
+  bool ParseStat(std::string_view text, Stat& stat);
+
+  // Value of a "Key:  value" line in a status-like file
+  std::string_view FindField(std::string_view text, std::string_view key);
+
+  bool ListTasks(int pid, std::vector<int>& tids);
+  // Number of entries in /proc/<pid>/fd
+  int CountOpenFds(int pid);
+}
+
+#endif
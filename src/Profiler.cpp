@@ -0,0 +1,65 @@
+#include "Profiler.hpp"
+#include "Trace.hpp"
+#include <cstring>
+
+std::deque<Profiler::Section> Profiler::sections = {};
+Profiler::History Profiler::frameTimes = {};
+Profiler::History Profiler::frameSBCalls = {};
+uint32_t Profiler::currentFrameSBCalls = 0;
+thread_local Profiler::Scope* Profiler::current = nullptr;
+
+Profiler::Scope::Scope(const char* name):
+  section(GetSection(name)),
+  parent(current),
+  start(Clock::now())
+{
+  current = this;
+}
+
+Profiler::Scope::~Scope() {
+  auto end = Clock::now();
+  auto elapsed = std::chrono::duration<float, std::milli>(end - start).count();
+  section.frame_ms += elapsed;
+  Trace::Record(section.name, "ui", start, end);
+  current = parent;
+}
+
+void Profiler::EndFrame(float frame_time_ms) {
+  frameTimes.Push(frame_time_ms);
+  frameSBCalls.Push((float)currentFrameSBCalls);
+  currentFrameSBCalls = 0;
+  for (auto& section : sections) {
+    section.times_ms.Push(section.frame_ms);
+    section.sb_calls.Push((float)section.frame_sb_calls);
+    section.frame_ms = 0.f;
+    section.frame_sb_calls = 0;
+  }
+}
+
+void Profiler::CountSBCall() {
+  if (!current) return;
+  currentFrameSBCalls++;
+  for (Scope* scope = current; scope; scope = scope->parent)
+    scope->section.frame_sb_calls++;
+}
+
+const Profiler::History& Profiler::GetFrameSBCalls() {
+  return frameSBCalls;
+}
+
+const Profiler::History& Profiler::GetFrameTimes() {
+  return frameTimes;
+}
+
+const std::deque<Profiler::Section>& Profiler::GetSections() {
+  return sections;
+}
+
+Profiler::Section& Profiler::GetSection(const char* name) {
+  // A handful of sections, all named by string literals
+  for (auto& section : sections) {
+    if (section.name == name || std::strcmp(section.name, name) == 0)
+      return section;
+  }
+  return sections.emplace_back(Section{.name = name});
+}
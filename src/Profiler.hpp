@@ -0,0 +1,57 @@
+#ifndef PROFILER_HPP
+#define PROFILER_HPP
+#include <chrono>
+#include <deque>
+#include "RingBuffer.hpp"
+
+// Frame profiler for the UI thread. Scopes accumulate CPU time per named
+//   section during a frame, EndFrame() commits the totals into rolling histories.
+class Profiler {
+  public:
+    static constexpr size_t HistoryLength = 240;
+    using Clock = std::chrono::steady_clock;
+    using History = RingBuffer<float, HistoryLength>;
+
+    struct Section {
+      const char* name;
+      History times_ms;
+      History sb_calls;
+      float frame_ms = 0.f;
+      uint32_t frame_sb_calls = 0;
+    };
+
+    class Scope {
+      public:
+        Scope(const char* name);
+        ~Scope();
+      private:
+        friend Profiler;
+        Section& section;
+        Scope* parent;
+        Clock::time_point start;
+    };
+
+  public:
+    static void EndFrame(float frame_time_ms);
+    // One SB API call made on this thread, counted against every open scope
+    //   like their times are. Outside of a scope, so on any other thread,
+    //   it's dropped
+    static void CountSBCall();
+
+    static const History& GetFrameSBCalls();
+
+    static const History& GetFrameTimes();
+    static const std::deque<Section>& GetSections();
+
+  private:
+    static Section& GetSection(const char* name);
+
+  private:
+    static std::deque<Section> sections;
+    static History frameTimes;
+    static History frameSBCalls;
+    static uint32_t currentFrameSBCalls;
+    static thread_local Scope* current;
+};
+
+#endif
@@ -0,0 +1,110 @@
+#include "Registers.hpp"
+#include "Trace.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <unordered_map>
+#include <fmt/core.h>
+
+const char* Registers::LaneName(Lane lane) {
+  switch (lane) {
+    case Lane::I8: return "i8";
+    case Lane::I16: return "i16";
+    case Lane::I32: return "i32";
+    case Lane::I64: return "i64";
+    case Lane::F32: return "f32";
+    case Lane::F64: return "f64";
+    default: return "?";
+  }
+}
+
+uint32_t Registers::LaneSize(Lane lane) {
+  switch (lane) {
+    case Lane::I8: return 1;
+    case Lane::I16: return 2;
+    case Lane::I32: case Lane::F32: return 4;
+    case Lane::I64: case Lane::F64: return 8;
+    default: return 1;
+  }
+}
+
+bool Registers::Register::IsVector() const {
+  const size_t size = bytes.size();
+  return size == 16 || size == 32 || size == 64;
+}
+
+size_t Registers::Register::FormatLane(Lane lane, uint32_t index, char* out, size_t size) const {
+  const uint32_t lane_size = LaneSize(lane);
+  if ((index + 1) * lane_size > bytes.size()) return 0;
+  const uint8_t* at = bytes.data() + index * lane_size;
+  // format_to_n reports the untruncated length
+  auto written = [size](fmt::format_to_n_result<char*> result) { return std::min<size_t>(result.size, size); };
+  switch (lane) {
+    case Lane::I8: { int8_t v; memcpy(&v, at, lane_size); return written(fmt::format_to_n(out, size, "{}", v)); }
+    case Lane::I16: { int16_t v; memcpy(&v, at, lane_size); return written(fmt::format_to_n(out, size, "{}", v)); }
+    case Lane::I32: { int32_t v; memcpy(&v, at, lane_size); return written(fmt::format_to_n(out, size, "{}", v)); }
+    case Lane::I64: { int64_t v; memcpy(&v, at, lane_size); return written(fmt::format_to_n(out, size, "{}", v)); }
+    case Lane::F32: { float v; memcpy(&v, at, lane_size); return written(fmt::format_to_n(out, size, "{:g}", v)); }
+    case Lane::F64: { double v; memcpy(&v, at, lane_size); return written(fmt::format_to_n(out, size, "{:g}", v)); }
+    default: return 0;
+  }
+}
+
+bool Registers::Register::LaneChanged(Lane lane, uint32_t index) const {
+  const uint32_t size = LaneSize(lane);
+  for (uint32_t i = index * size; i < (index + 1) * size && i < changed_bytes.size(); i++)
+    if (changed_bytes[i]) return true;
+  return false;
+}
+
+Registers::Snapshot Registers::Take(lldb::SBFrame frame, uint32_t stop_id, uint32_t thread_index, const Snapshot* previous) {
+  Trace::Scope t("Registers", "registers");
+  auto start = std::chrono::steady_clock::now();
+  Snapshot snapshot{.stop_id = stop_id, .thread_index = thread_index, .frame_id = frame.GetFrameID()};
+  if (previous && (previous->thread_index != thread_index || previous->frame_id != snapshot.frame_id))
+    previous = nullptr;
+
+  // Previous values by name, registers can repeat across sets
+  std::unordered_map<std::string_view, const Register*> before;
+  if (previous)
+    for (const Set& set : previous->sets)
+      for (const Register& reg : set.registers)
+        before.emplace(reg.name, &reg);
+
+  lldb::SBValueList register_sets = frame.GetRegisters();
+  for (uint32_t i = 0; i < register_sets.GetSize(); i++) {
+    lldb::SBValue sb_set = register_sets.GetValueAtIndex(i);
+    Set set{.name = sb_set.GetName() ? sb_set.GetName() : "?"};
+    const uint32_t count = sb_set.GetNumChildren();
+    set.registers.reserve(count);
+    for (uint32_t r = 0; r < count; r++) {
+      lldb::SBValue sb_reg = sb_set.GetChildAtIndex(r);
+      const char* name = sb_reg.GetName();
+      if (!name) continue;
+      Register reg{.name = name};
+      if (const char* value = sb_reg.GetValue()) reg.value = value;
+      lldb::SBData data = sb_reg.GetData();
+      lldb::SBError error;
+      reg.bytes.resize(data.GetByteSize());
+      if (data.ReadRawData(error, 0, reg.bytes.data(), reg.bytes.size()) != reg.bytes.size())
+        reg.bytes.clear();
+
+      if (auto it = before.find(reg.name); it != before.end() && it->second->bytes.size() == reg.bytes.size()) {
+        const Register& old = *it->second;
+        reg.changed_bytes.resize(reg.bytes.size());
+        for (size_t b = 0; b < reg.bytes.size(); b++) {
+          reg.changed_bytes[b] = old.bytes[b] != reg.bytes[b];
+          reg.changed |= reg.changed_bytes[b];
+        }
+        // Registers LLDB couldn't read have no bytes, compare the text
+        if (reg.bytes.empty())
+          reg.changed = old.value != reg.value;
+        snapshot.changed += reg.changed;
+      }
+      set.registers.push_back(std::move(reg));
+    }
+    snapshot.sets.push_back(std::move(set));
+  }
+  snapshot.ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+  return snapshot;
+}
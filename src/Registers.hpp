@@ -0,0 +1,50 @@
+#ifndef REGISTERS_HPP
+#define REGISTERS_HPP
+#include <lldb/API/LLDB.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// A frame's registers by set, with their raw bytes so vector registers can be
+//   shown as lanes. Changes are found by comparing bytes with the snapshot of
+//   the same thread and frame from an earlier stop
+class Registers {
+  public:
+    enum class Lane { I8, I16, I32, I64, F32, F64, Count };
+    static const char* LaneName(Lane lane);
+    static uint32_t LaneSize(Lane lane);
+
+    struct Register {
+      std::string name;
+      std::string value; // LLDB's own formatting
+      std::vector<uint8_t> bytes; // target byte order
+      bool changed = false;
+      // Byte offsets that changed, for highlighting lanes
+      std::vector<bool> changed_bytes;
+      // XMM/YMM/ZMM, NEON Q/V and the like
+      bool IsVector() const;
+      // Writes lane i as text into out, truncated to size, and returns its
+      //   length. Little endian targets only
+      size_t FormatLane(Lane lane, uint32_t index, char* out, size_t size) const;
+      bool LaneChanged(Lane lane, uint32_t index) const;
+    };
+    struct Set {
+      std::string name;
+      std::vector<Register> registers;
+    };
+    struct Snapshot {
+      uint32_t stop_id;
+      uint32_t thread_index;
+      uint32_t frame_id;
+      std::vector<Set> sets;
+      size_t changed = 0;
+      float ms = 0.f;
+    };
+
+  public:
+    // Marks changes against previous when it's for the same thread and frame
+    static Snapshot Take(lldb::SBFrame frame, uint32_t stop_id, uint32_t thread_index, const Snapshot* previous);
+};
+
+#endif
@@ -0,0 +1,139 @@
+#include "ResourceMonitor.hpp"
+#include "Logger.hpp"
+#include "Trace.hpp"
+#include <charconv>
+#include <chrono>
+#include <fmt/core.h>
+
+ResourceMonitor::~ResourceMonitor() {
+  Stop();
+}
+
+void ResourceMonitor::Start(int _pid) {
+  Stop();
+  if (!ProcFS::IsSupported()) return;
+  pid = _pid;
+  if (!stat.Open(fmt::format("/proc/{}/stat", pid))) {
+    Logger::Warn("Resource monitor: can't read /proc/{}/stat", pid);
+    return;
+  }
+  statm.Open(fmt::format("/proc/{}/statm", pid));
+  io.Open(fmt::format("/proc/{}/io", pid));
+  hasLast = false;
+  sampleCount = 0;
+  {
+    std::lock_guard lock(mutex);
+    series = Series{};
+  }
+  running = true;
+  thread = std::thread([this]() {
+    Trace::SetThreadName("Resource Monitor");
+    MonitorThread();
+  });
+}
+
+void ResourceMonitor::Stop() {
+  running = false;
+  if (thread.joinable())
+    thread.join();
+}
+
+bool ResourceMonitor::IsRunning() const {
+  return running;
+}
+
+ResourceMonitor::Series ResourceMonitor::GetSeries() {
+  std::lock_guard lock(mutex);
+  return series;
+}
+
+void ResourceMonitor::MonitorThread() {
+  using clock = std::chrono::steady_clock;
+  auto last = clock::now();
+  while (running) {
+    auto now = clock::now();
+    Sample(std::chrono::duration<float>(now - last).count());
+    last = now;
+
+    bool stopped;
+    {
+      std::lock_guard lock(mutex);
+      stopped = !series.stopped.Empty() && series.stopped.Back() > 0.f;
+    }
+    // Nothing changes much while stopped at a breakpoint, but keep going so a
+    //   long stop still shows up in the series. Sleep in slices to stay stoppable
+    auto next = now + std::chrono::milliseconds(1000 / (stopped ? StoppedRate : RunningRate));
+    while (running && clock::now() < next)
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  }
+}
+
+void ResourceMonitor::Sample(float elapsed_s) {
+  Trace::Scope t("Sample Resources", "monitor");
+  long n = stat.Read(buffer, sizeof(buffer));
+  ProcFS::Stat process_stat;
+  if (n <= 0 || !ProcFS::ParseStat(std::string_view(buffer, n), process_stat)) {
+    running = false;
+    return;
+  }
+  const uint64_t ticks = process_stat.utime + process_stat.stime;
+  // 't' is a tracing stop, i.e. held by the debugger
+  const bool stopped = process_stat.state == 't' || process_stat.state == 'T';
+
+  const float mb = (float)ProcFS::PageSize() / (1024.f * 1024.f);
+  float rss_mb = process_stat.rss_pages * mb;
+  float data_mb = 0.f;
+  n = statm.Read(buffer, sizeof(buffer));
+  if (n > 0) {
+    // size resident shared text lib data dt, all in pages
+    uint64_t fields[6] = {};
+    const char* p = buffer;
+    const char* end = buffer + n;
+    for (auto& field : fields) {
+      while (p < end && *p == ' ') p++;
+      p = std::from_chars(p, end, field).ptr;
+    }
+    rss_mb = fields[1] * mb;
+    data_mb = fields[5] * mb;
+  }
+
+  bool io_available = false;
+  uint64_t read_bytes = 0, write_bytes = 0;
+  n = io.Read(buffer, sizeof(buffer));
+  if (n > 0) {
+    std::string_view text(buffer, n);
+    auto rchar = ProcFS::FindField(text, "rchar");
+    auto wchar = ProcFS::FindField(text, "wchar");
+    io_available = !rchar.empty() && !wchar.empty();
+    std::from_chars(rchar.data(), rchar.data() + rchar.size(), read_bytes);
+    std::from_chars(wchar.data(), wchar.data() + wchar.size(), write_bytes);
+  }
+
+  // Listing fd/ is the only expensive read, and the count rarely moves
+  if (sampleCount % 4 == 0)
+    lastFds = (float)ProcFS::CountOpenFds(pid);
+  sampleCount++;
+
+  float cpu = 0.f, read_kbs = 0.f, write_kbs = 0.f;
+  if (hasLast && elapsed_s > 0.f) {
+    cpu = 100.f * (float)(ticks - lastTicks) / (float)ProcFS::TicksPerSecond() / elapsed_s;
+    read_kbs = (float)(read_bytes - lastRead) / 1024.f / elapsed_s;
+    write_kbs = (float)(write_bytes - lastWrite) / 1024.f / elapsed_s;
+  }
+  lastTicks = ticks;
+  lastRead = read_bytes;
+  lastWrite = write_bytes;
+  hasLast = true;
+
+  std::lock_guard lock(mutex);
+  series.rss_mb.Push(rss_mb);
+  series.data_mb.Push(data_mb);
+  series.cpu.Push(cpu);
+  series.threads.Push((float)process_stat.num_threads);
+  series.fds.Push(lastFds);
+  series.read_kbs.Push(read_kbs);
+  series.write_kbs.Push(write_kbs);
+  series.stopped.Push(stopped ? 1.f : 0.f);
+  series.io_available = io_available;
+  series.samples = sampleCount;
+}
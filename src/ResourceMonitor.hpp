@@ -0,0 +1,65 @@
+#ifndef RESOURCE_MONITOR_HPP
+#define RESOURCE_MONITOR_HPP
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include "ProcFS.hpp"
+#include "RingBuffer.hpp"
+
+// Time series of the inferior's memory, CPU, fd and I/O usage read from
+//   /proc/<pid>. Runs for the whole life of a launched process, sampling less
+//   often while it sits stopped in the debugger.
+class ResourceMonitor {
+  public:
+    static constexpr int RunningRate = 4;
+    static constexpr int StoppedRate = 1;
+    static constexpr size_t HistoryLength = 600;
+    using History = RingBuffer<float, HistoryLength>;
+
+    struct Series {
+      History rss_mb;
+      History data_mb;
+      History cpu;       // percent of one core
+      History threads;
+      History fds;
+      History read_kbs;  // rchar/wchar from io, all read/write syscalls
+      History write_kbs;
+      History stopped;   // 1 while stopped in the debugger
+      bool io_available = false;
+      uint64_t samples = 0;
+    };
+
+  public:
+    ~ResourceMonitor();
+    void Start(int pid);
+    void Stop();
+    bool IsRunning() const;
+    // Copy, written by the monitor thread
+    Series GetSeries();
+
+  private:
+    void MonitorThread();
+    void Sample(float elapsed_s);
+
+  private:
+    std::thread thread;
+    std::atomic<bool> running = false;
+    int pid = 0;
+
+    std::mutex mutex;
+    Series series;
+
+    // Monitor thread only
+    ProcFS::File statm;
+    ProcFS::File stat;
+    ProcFS::File io;
+    uint64_t lastTicks = 0;
+    uint64_t lastRead = 0;
+    uint64_t lastWrite = 0;
+    bool hasLast = false;
+    float lastFds = 0.f;
+    uint64_t sampleCount = 0;
+    char buffer[4096];
+};
+
+#endif
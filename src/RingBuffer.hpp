@@ -0,0 +1,57 @@
+#ifndef RING_BUFFER_HPP
+#define RING_BUFFER_HPP
+#include <algorithm>
+#include <array>
+#include <cstddef>
+
+// Fixed capacity history that overwrites its oldest entry once full.
+//   Laid out so ImGui::PlotLines can draw it directly using GetOffset().
+template <typename T, size_t N>
+class RingBuffer {
+  public:
+    void Push(const T& value) {
+      values[head] = value;
+      head = (head + 1) % N;
+      if (size < N) size++;
+    }
+
+    void Clear() {
+      head = 0;
+      size = 0;
+    }
+
+    // i = 0 is the oldest element
+    const T& operator[](size_t i) const {
+      return values[(head + N - size + i) % N];
+    }
+
+    const T& Back() const {
+      return values[(head + N - 1) % N];
+    }
+
+    // Nearest-rank percentile over the stored values, p in [0, 1]
+    T Percentile(float p) const {
+      if (size == 0) return T{};
+      std::array<T, N> sorted;
+      for (size_t i = 0; i < size; i++)
+        sorted[i] = (*this)[i];
+      size_t n = std::min<size_t>(size - 1, (size_t)(p * size));
+      std::nth_element(sorted.begin(), sorted.begin() + n, sorted.begin() + size);
+      return sorted[n];
+    }
+
+    size_t Size() const { return size; }
+    bool Empty() const { return size == 0; }
+    static constexpr size_t Capacity() { return N; }
+
+    const T* Data() const { return values.data(); }
+    // Index of the oldest element inside Data() once the buffer has wrapped
+    size_t GetOffset() const { return size < N ? 0 : head; }
+
+  private:
+    std::array<T, N> values{};
+    size_t head = 0;
+    size_t size = 0;
+};
+
+#endif
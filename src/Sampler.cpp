@@ -0,0 +1,247 @@
+#include "Sampler.hpp"
+#include "Logger.hpp"
+#include "Trace.hpp"
+#include <algorithm>
+#include <fmt/core.h>
+
+Sampler::~Sampler() {
+  Stop();
+}
+
+void Sampler::Start(lldb::SBProcess _process, int rate_hz) {
+  Stop();
+  process = _process;
+  target = process.GetTarget();
+  SetRate(rate_hz);
+  {
+    std::lock_guard lock(mutex);
+    pending = false;
+    pendingPCs.clear();
+    pendingStackEnds.clear();
+    sampleCount = 0;
+    stackCount = 0;
+    interruptMs.Clear();
+    pauseMs.Clear();
+    published.reset();
+  }
+  profile = Profile{};
+  profile.symbols.push_back("[all]");
+  profile.nodes.push_back(Node{.symbol = 0, .depth = 0});
+  symbolByAddress.clear();
+  symbolByName.clear();
+  childByKey.clear();
+  profileDirty = true;
+
+  running = true;
+  thread = std::thread([this]() {
+    Trace::SetThreadName("Sampler");
+    SamplerThread();
+  });
+  Logger::Info("Sampling at {} Hz", rate.load());
+}
+
+void Sampler::Stop() {
+  running = false;
+  if (thread.joinable())
+    thread.join();
+}
+
+bool Sampler::IsRunning() const {
+  return running;
+}
+
+void Sampler::SetRate(int rate_hz) {
+  rate = std::clamp(rate_hz, MinRate, MaxRate);
+}
+
+int Sampler::GetRate() const {
+  return rate;
+}
+
+void Sampler::SamplerThread() {
+  auto next = Clock::now();
+  auto nextPublish = next;
+  while (running) {
+    auto period = std::chrono::microseconds(1'000'000 / rate);
+    next += period;
+    std::this_thread::sleep_until(next);
+    // Don't fire a burst of interrupts to catch up after sitting at a breakpoint
+    if (Clock::now() > next + period)
+      next = Clock::now();
+
+    bool request = false;
+    {
+      std::lock_guard lock(mutex);
+      if (!pending && process.GetState() == lldb::eStateRunning) {
+        pending = true;
+        requestedAt = Clock::now();
+        request = true;
+      }
+    }
+    if (request)
+      process.Stop();
+
+    Aggregate();
+    if (profileDirty && Clock::now() >= nextPublish) {
+      Publish();
+      nextPublish = Clock::now() + std::chrono::milliseconds(250);
+    }
+  }
+  Aggregate();
+  Publish();
+}
+
+bool Sampler::IsSampleStop(const lldb::SBEvent& event) {
+  std::lock_guard lock(mutex);
+  return pending || (running && lldb::SBProcess::GetInterruptedFromEvent(event));
+}
+
+bool Sampler::TryTakeSample(const lldb::SBEvent& event) {
+  if (!IsSampleStop(event)) return false;
+  auto stoppedAt = Clock::now();
+
+  // Whatever the interrupt ran into, a thread stopped for its own reason makes
+  //   this a real stop
+  const int sigstop = process.GetUnixSignals().GetSignalNumberFromName("SIGSTOP");
+  std::vector<lldb::addr_t> pcs;
+  std::vector<uint32_t> stack_ends;
+  bool sample = true;
+  const uint32_t thread_count = process.GetNumThreads();
+  for (uint32_t i = 0; i < thread_count && sample; i++) {
+    lldb::SBThread thread = process.GetThreadAtIndex(i);
+    switch (thread.GetStopReason()) {
+      case lldb::eStopReasonNone:
+      case lldb::eStopReasonInvalid:
+        break;
+      case lldb::eStopReasonSignal:
+        sample = (int)thread.GetStopReasonDataAtIndex(0) == sigstop;
+        break;
+      default:
+        sample = false;
+        break;
+    }
+    const uint32_t depth = std::min<uint32_t>(thread.GetNumFrames(), MaxDepth);
+    for (uint32_t f = 0; f < depth; f++) {
+      lldb::addr_t pc = thread.GetFrameAtIndex(f).GetPC();
+      if (pc == LLDB_INVALID_ADDRESS) break;
+      pcs.push_back(f == 0 ? pc : pc - 1);
+    }
+    stack_ends.push_back((uint32_t)pcs.size());
+  }
+
+  if (!sample) {
+    std::lock_guard lock(mutex);
+    pending = false;
+    return false;
+  }
+
+  process.Continue();
+  auto continuedAt = Clock::now();
+
+  std::lock_guard lock(mutex);
+  uint32_t base = (uint32_t)pendingPCs.size();
+  pendingPCs.insert(pendingPCs.end(), pcs.begin(), pcs.end());
+  for (auto end : stack_ends)
+    pendingStackEnds.push_back(base + end);
+  if (pending)
+    interruptMs.Push(std::chrono::duration<float, std::milli>(stoppedAt - requestedAt).count());
+  pauseMs.Push(std::chrono::duration<float, std::milli>(continuedAt - stoppedAt).count());
+  sampleCount++;
+  stackCount += stack_ends.size();
+  pending = false;
+  return true;
+}
+
+void Sampler::Aggregate() {
+  {
+    std::lock_guard lock(mutex);
+    std::swap(pendingPCs, foldPCs);
+    std::swap(pendingStackEnds, foldStackEnds);
+  }
+  if (foldStackEnds.empty()) return;
+  Trace::Scope t("Fold Samples", "sampler");
+
+  // Symbolize every address not seen before in one batch, most samples land on
+  //   addresses that are already cached
+  std::vector<lldb::addr_t> unresolved;
+  for (auto pc : foldPCs)
+    if (!symbolByAddress.contains(pc))
+      unresolved.push_back(pc);
+  std::sort(unresolved.begin(), unresolved.end());
+  unresolved.erase(std::unique(unresolved.begin(), unresolved.end()), unresolved.end());
+  for (auto pc : unresolved)
+    symbolByAddress[pc] = Symbolize(pc);
+
+  uint32_t begin = 0;
+  for (auto end : foldStackEnds) {
+    uint32_t node = 0;
+    profile.nodes[0].total++;
+    // Root first, the leaf is at the front
+    for (uint32_t i = end; i > begin; i--) {
+      uint32_t symbol = symbolByAddress[foldPCs[i - 1]];
+      uint64_t key = ((uint64_t)node << 32) | symbol;
+      auto it = childByKey.find(key);
+      if (it == childByKey.end()) {
+        uint32_t child = (uint32_t)profile.nodes.size();
+        uint32_t depth = profile.nodes[node].depth + 1;
+        profile.nodes.push_back(Node{.symbol = symbol, .depth = depth});
+        profile.nodes[node].children.push_back(child);
+        profile.max_depth = std::max<uint32_t>(profile.max_depth, depth);
+        it = childByKey.emplace(key, child).first;
+      }
+      node = it->second;
+      profile.nodes[node].total++;
+    }
+    profile.nodes[node].self++;
+    begin = end;
+  }
+  foldPCs.clear();
+  foldStackEnds.clear();
+  profileDirty = true;
+}
+
+uint32_t Sampler::Symbolize(lldb::addr_t pc) {
+  lldb::SBAddress address = target.ResolveLoadAddress(pc);
+  lldb::SBSymbol symbol = address.GetSymbol();
+  std::string name;
+  if (symbol.IsValid() && symbol.GetDisplayName())
+    name = symbol.GetDisplayName();
+  else if (auto module = address.GetModule(); module.IsValid() && module.GetFileSpec().GetFilename())
+    name = fmt::format("{}+0x{:x}", module.GetFileSpec().GetFilename(), address.GetFileAddress());
+  else
+    name = fmt::format("0x{:x}", pc);
+
+  auto [it, inserted] = symbolByName.try_emplace(name, (uint32_t)profile.symbols.size());
+  if (inserted)
+    profile.symbols.push_back(std::move(name));
+  return it->second;
+}
+
+void Sampler::Publish() {
+  auto copy = std::make_shared<Profile>(profile);
+  for (auto& node : copy->nodes) {
+    std::sort(node.children.begin(), node.children.end(), [&](uint32_t a, uint32_t b) {
+      return copy->nodes[a].total > copy->nodes[b].total;
+    });
+  }
+  std::lock_guard lock(mutex);
+  copy->samples = sampleCount;
+  published = std::move(copy);
+  profileDirty = false;
+}
+
+std::shared_ptr<const Sampler::Profile> Sampler::GetProfile() {
+  std::lock_guard lock(mutex);
+  return published;
+}
+
+Sampler::Stats Sampler::GetStats() {
+  std::lock_guard lock(mutex);
+  return Stats{
+    .samples = sampleCount,
+    .stacks = stackCount,
+    .symbols = published ? published->symbols.size() : 0,
+    .interrupt_ms = interruptMs,
+    .pause_ms = pauseMs,
+  };
+}
@@ -0,0 +1,101 @@
+#ifndef SAMPLER_HPP
+#define SAMPLER_HPP
+#include <lldb/API/LLDB.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "RingBuffer.hpp"
+
+// Statistical profiler for a running process. A sampler thread interrupts the
+//   process at a fixed rate, the event thread grabs the PCs of every thread and
+//   continues straight away, and the stacks are symbolized and folded into a
+//   call tree off both of those threads.
+class Sampler {
+  public:
+    using Clock = std::chrono::steady_clock;
+    static constexpr int MinRate = 20;
+    static constexpr int MaxRate = 100;
+    static constexpr uint32_t MaxDepth = 128;
+    using History = RingBuffer<float, 512>;
+
+    struct Node {
+      uint32_t symbol;
+      uint32_t depth;
+      uint32_t total = 0;
+      uint32_t self = 0;
+      // Sorted by total, heaviest first
+      std::vector<uint32_t> children;
+    };
+    // Immutable once published, the UI holds on to it for as long as it likes
+    struct Profile {
+      std::vector<Node> nodes; // nodes[0] is the root
+      std::vector<std::string> symbols;
+      uint32_t max_depth = 0;
+      uint64_t samples = 0;
+    };
+    struct Stats {
+      uint64_t samples;
+      uint64_t stacks;
+      uint64_t symbols;
+      History interrupt_ms; // Stop requested -> stop event
+      History pause_ms;     // Stop event -> continued
+    };
+
+  public:
+    ~Sampler();
+    void Start(lldb::SBProcess process, int rate_hz);
+    void Stop();
+    bool IsRunning() const;
+    void SetRate(int rate_hz);
+    int GetRate() const;
+
+    // Event thread. Takes the sample and resumes the process if this stop is one
+    //   of ours, returns false for any stop the user should see
+    bool TryTakeSample(const lldb::SBEvent& event);
+
+    std::shared_ptr<const Profile> GetProfile();
+    Stats GetStats();
+
+  private:
+    void SamplerThread();
+    bool IsSampleStop(const lldb::SBEvent& event);
+    void Aggregate();
+    uint32_t Symbolize(lldb::addr_t pc);
+    void Publish();
+
+  private:
+    std::thread thread;
+    std::atomic<bool> running = false;
+    std::atomic<int> rate = 50;
+    lldb::SBProcess process;
+    lldb::SBTarget target;
+
+    std::mutex mutex;
+    bool pending = false;
+    Clock::time_point requestedAt;
+    // Captured stacks waiting to be folded, leaf first and flattened. Callers
+    //   are stored as return address - 1 so they resolve inside the call
+    std::vector<lldb::addr_t> pendingPCs;
+    std::vector<uint32_t> pendingStackEnds;
+    uint64_t sampleCount = 0;
+    uint64_t stackCount = 0;
+    History interruptMs;
+    History pauseMs;
+    std::shared_ptr<const Profile> published;
+
+    // Sampler thread only
+    Profile profile;
+    std::vector<lldb::addr_t> foldPCs;
+    std::vector<uint32_t> foldStackEnds;
+    std::unordered_map<lldb::addr_t, uint32_t> symbolByAddress;
+    std::unordered_map<std::string, uint32_t> symbolByName;
+    std::unordered_map<uint64_t, uint32_t> childByKey; // (parent << 32) | symbol
+    bool profileDirty = false;
+};
+
+#endif
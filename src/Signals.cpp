@@ -0,0 +1,127 @@
+#include "Signals.hpp"
+#include "Logger.hpp"
+#include "Trace.hpp"
+#include <algorithm>
+#include <cctype>
+#include <string_view>
+
+namespace {
+  void ApplyOverride(lldb::SBUnixSignals& signals, int32_t number, std::optional<bool> pass, std::optional<bool> stop, std::optional<bool> notify) {
+    if (pass) signals.SetShouldSuppress(number, !*pass);
+    if (stop) signals.SetShouldStop(number, *stop);
+    if (notify) signals.SetShouldNotify(number, *notify);
+  }
+}
+
+bool Signals::Set(lldb::SBProcess process, const std::string& name, std::optional<bool> pass, std::optional<bool> stop, std::optional<bool> notify) {
+  lldb::SBUnixSignals signals = process.IsValid() ? process.GetUnixSignals() : lldb::SBUnixSignals();
+  if (signals.IsValid()) {
+    const int32_t number = signals.GetSignalNumberFromName(name.c_str());
+    if (number == LLDB_INVALID_SIGNAL_NUMBER) {
+      Logger::Err("Unknown signal '{}'", name);
+      return false;
+    }
+    ApplyOverride(signals, number, pass, stop, notify);
+  }
+
+  std::lock_guard lock(mutex);
+  auto& entry = overrides[name];
+  if (pass) entry.pass = pass;
+  if (stop) entry.stop = stop;
+  if (notify) entry.notify = notify;
+  if (signals.IsValid()) {
+    RefreshTable(signals);
+  }
+  else {
+    // Before launch the table only holds what was asked for, LLDB's defaults
+    //   aren't known yet
+    auto it = std::find_if(table.begin(), table.end(), [&](const Policy& p) { return p.name == name; });
+    if (it == table.end())
+      it = table.insert(table.end(), Policy{name, 0, true, true, true, 0});
+    it->pass = entry.pass.value_or(it->pass);
+    it->stop = entry.stop.value_or(it->stop);
+    it->notify = entry.notify.value_or(it->notify);
+  }
+  Logger::Info("Signal {}: pass {} stop {} notify {}", name,
+    entry.pass ? (*entry.pass ? "yes" : "no") : "-",
+    entry.stop ? (*entry.stop ? "yes" : "no") : "-",
+    entry.notify ? (*entry.notify ? "yes" : "no") : "-");
+  return true;
+}
+
+void Signals::Apply(lldb::SBProcess process) {
+  lldb::SBUnixSignals signals = process.GetUnixSignals();
+  if (!signals.IsValid()) return;
+  std::lock_guard lock(mutex);
+  for (const auto& [name, entry] : overrides) {
+    const int32_t number = signals.GetSignalNumberFromName(name.c_str());
+    if (number == LLDB_INVALID_SIGNAL_NUMBER) {
+      Logger::Warn("Signal '{}' doesn't exist in this process", name);
+      continue;
+    }
+    ApplyOverride(signals, number, entry.pass, entry.stop, entry.notify);
+  }
+  totalPassed = 0;
+  table.clear();
+  RefreshTable(signals);
+}
+
+void Signals::RefreshTable(lldb::SBUnixSignals& signals) {
+  std::map<std::string, uint64_t> passed;
+  for (const auto& policy : table)
+    passed[policy.name] = policy.passed;
+  table.clear();
+  const int32_t count = signals.GetNumSignals();
+  table.reserve(count);
+  for (int32_t i = 0; i < count; i++) {
+    const int32_t number = signals.GetSignalAtIndex(i);
+    const char* name = signals.GetSignalAsCString(number);
+    if (!name) continue;
+    auto it = passed.find(name);
+    table.push_back(Policy{
+      .name = name,
+      .number = number,
+      .pass = !signals.GetShouldSuppress(number),
+      .stop = signals.GetShouldStop(number),
+      .notify = signals.GetShouldNotify(number),
+      .passed = it == passed.end() ? 0 : it->second,
+    });
+  }
+  std::sort(table.begin(), table.end(), [](const Policy& a, const Policy& b) { return a.number < b.number; });
+}
+
+std::vector<Signals::Policy> Signals::GetPolicies() {
+  std::lock_guard lock(mutex);
+  return table;
+}
+
+uint64_t Signals::GetTotalPassed() const {
+  return totalPassed.load(std::memory_order_relaxed);
+}
+
+void Signals::CountRestart(const lldb::SBEvent& event) {
+  // The process is running again, so the threads can't be asked. LLDB names
+  //   the signal in the restart reasons ("... signal SIGPROF ..."). Restarts
+  //   for anything else, like auto-continue breakpoints, name none
+  const size_t reasons = lldb::SBProcess::GetNumRestartedReasonsFromEvent(event);
+  for (size_t i = 0; i < reasons; i++) {
+    const char* reason = lldb::SBProcess::GetRestartedReasonAtIndexFromEvent(event, i);
+    if (!reason) continue;
+    std::string_view text(reason);
+    size_t start = text.find("SIG");
+    if (start == std::string_view::npos) continue;
+    size_t end = start + 3;
+    while (end < text.size() && (std::isalnum((unsigned char)text[end]) || text[end] == '+' || text[end] == '-'))
+      end++;
+    std::string_view name = text.substr(start, end - start);
+    if (name.size() <= 3) continue;
+    totalPassed.fetch_add(1, std::memory_order_relaxed);
+    std::lock_guard lock(mutex);
+    for (auto& policy : table) {
+      if (policy.name == name) {
+        policy.passed++;
+        break;
+      }
+    }
+  }
+}
@@ -0,0 +1,55 @@
+#ifndef SIGNALS_HPP
+#define SIGNALS_HPP
+#include <lldb/API/LLDB.h>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+// Per signal pass/stop/notify policy, backed by the process' SBUnixSignals.
+//   Changes made before launch are kept and applied to every new process.
+//   A signal that passes without stopping is resumed by LLDB itself. With
+//   notify on, the event thread only counts it, nothing else wakes up
+class Signals {
+  public:
+    struct Policy {
+      std::string name;
+      int32_t number;
+      bool pass;
+      bool stop;
+      bool notify;
+      uint64_t passed; // only counted while notify is on
+    };
+
+  public:
+    // Unset fields keep their current value. Applied right away when the
+    //   process is valid
+    bool Set(lldb::SBProcess process, const std::string& name, std::optional<bool> pass, std::optional<bool> stop, std::optional<bool> notify);
+    void Apply(lldb::SBProcess process);
+    // Every signal of the process, or only the changed ones before launch.
+    //   Cached, no SB calls
+    std::vector<Policy> GetPolicies();
+    // Counts the signals named by a stop event LLDB already resumed from
+    void CountRestart(const lldb::SBEvent& event);
+    uint64_t GetTotalPassed() const;
+
+  private:
+    struct Override {
+      std::optional<bool> pass;
+      std::optional<bool> stop;
+      std::optional<bool> notify;
+    };
+
+  private:
+    void RefreshTable(lldb::SBUnixSignals& signals);
+
+  private:
+    std::mutex mutex;
+    std::map<std::string, Override> overrides;
+    std::vector<Policy> table;
+    std::atomic<uint64_t> totalPassed = 0;
+};
+
+#endif
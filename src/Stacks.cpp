@@ -0,0 +1,123 @@
+#include "Stacks.hpp"
+#include "Logger.hpp"
+#include "Trace.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <unordered_map>
+#include <fmt/core.h>
+
+Stacks::Snapshot Stacks::Collect(lldb::SBProcess process, size_t max_workers) {
+  Trace::Scope t("Collect Stacks", "stacks");
+  using clock = std::chrono::steady_clock;
+  auto start = clock::now();
+
+  Snapshot snapshot;
+  snapshot.stop_id = process.GetStopID();
+  snapshot.thread_count = process.GetNumThreads();
+
+  struct ThreadStack {
+    uint32_t index_id = 0;
+    uint64_t hash = 0;
+    std::vector<lldb::addr_t> pcs;
+  };
+  std::vector<ThreadStack> stacks(snapshot.thread_count);
+
+  if (max_workers == 0) {
+    const size_t hardware_threads = std::thread::hardware_concurrency();
+    max_workers = hardware_threads ? hardware_threads : 1;
+  }
+  snapshot.worker_count = std::clamp<size_t>(snapshot.thread_count / 32, 1, max_workers);
+
+  std::atomic<size_t> next_thread = 0;
+  auto worker = [&]() {
+    for (size_t i; (i = next_thread.fetch_add(1, std::memory_order_relaxed)) < stacks.size();) {
+      auto& stack = stacks[i];
+      lldb::SBThread thread = process.GetThreadAtIndex(i);
+      if (!thread.IsValid()) continue;
+      stack.index_id = thread.GetIndexID();
+      const uint32_t depth = std::min<uint32_t>(thread.GetNumFrames(), MaxDepth);
+      stack.pcs.reserve(depth);
+      uint64_t hash = 0xcbf29ce484222325ull;
+      for (uint32_t f = 0; f < depth; f++) {
+        lldb::addr_t pc = thread.GetFrameAtIndex(f).GetPC();
+        stack.pcs.push_back(pc);
+        hash = (hash ^ pc) * 0x100000001b3ull;
+      }
+      stack.hash = hash;
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < snapshot.worker_count; i++)
+    threads.emplace_back(worker);
+  worker();
+  for (auto& thread : threads)
+    thread.join();
+
+  auto collected = clock::now();
+  snapshot.collect_ms = std::chrono::duration<float, std::milli>(collected - start).count();
+
+  // Hash first, the PCs are only compared to rule out a collision
+  std::unordered_map<uint64_t, uint32_t> group_by_hash;
+  group_by_hash.reserve(stacks.size());
+  for (auto& stack : stacks) {
+    auto [it, inserted] = group_by_hash.try_emplace(stack.hash, (uint32_t)snapshot.groups.size());
+    Group* group = inserted ? nullptr : &snapshot.groups[it->second];
+    if (group && group->pcs != stack.pcs) {
+      auto match = std::find_if(snapshot.groups.begin(), snapshot.groups.end(), [&](const Group& g) {
+        return g.pcs == stack.pcs;
+      });
+      group = match == snapshot.groups.end() ? nullptr : &*match;
+    }
+    if (!group) {
+      group = &snapshot.groups.emplace_back();
+      group->hash = stack.hash;
+      group->pcs = std::move(stack.pcs);
+    }
+    group->thread_ids.push_back(stack.index_id);
+  }
+  std::sort(snapshot.groups.begin(), snapshot.groups.end(), [](const Group& a, const Group& b) {
+    return a.thread_ids.size() > b.thread_ids.size();
+  });
+
+  // Only one lookup per distinct address, groups tend to share most of their frames
+  lldb::SBTarget target = process.GetTarget();
+  std::unordered_map<lldb::addr_t, std::string> labels;
+  for (auto& group : snapshot.groups) {
+    group.frames.reserve(group.pcs.size());
+    for (size_t f = 0; f < group.pcs.size(); f++) {
+      lldb::addr_t pc = group.pcs[f];
+      auto it = labels.find(pc);
+      if (it == labels.end())
+        it = labels.emplace(pc, Symbolize(target, pc, f == 0)).first;
+      group.frames.push_back(Frame{.pc = pc, .label = it->second});
+    }
+
+    std::sort(group.thread_ids.begin(), group.thread_ids.end());
+    constexpr size_t MaxListed = 32;
+    for (size_t i = 0; i < group.thread_ids.size() && i < MaxListed; i++)
+      group.threads_label += fmt::format("{}{}", i ? ", " : "", group.thread_ids[i]);
+    if (group.thread_ids.size() > MaxListed)
+      group.threads_label += fmt::format(" (+{} more)", group.thread_ids.size() - MaxListed);
+  }
+
+  snapshot.group_ms = std::chrono::duration<float, std::milli>(clock::now() - collected).count();
+  Logger::Info("Stacks: {} threads -> {} unique in {:.2f} ms ({} workers) + {:.2f} ms grouping",
+    snapshot.thread_count, snapshot.groups.size(), snapshot.collect_ms, snapshot.worker_count, snapshot.group_ms);
+  return snapshot;
+}
+
+std::string Stacks::Symbolize(lldb::SBTarget& target, lldb::addr_t pc, bool leaf) {
+  // Caller frames hold return addresses, which can belong to the next line
+  lldb::SBAddress address = target.ResolveLoadAddress(leaf ? pc : pc - 1);
+  lldb::SBSymbol symbol = address.GetSymbol();
+  std::string label = symbol.IsValid() && symbol.GetDisplayName()
+    ? symbol.GetDisplayName()
+    : fmt::format("0x{:x}", pc);
+  lldb::SBLineEntry line_entry = address.GetLineEntry();
+  if (line_entry.IsValid() && line_entry.GetFileSpec().GetFilename())
+    label += fmt::format(" at {}:{}", line_entry.GetFileSpec().GetFilename(), line_entry.GetLine());
+  return label;
+}
@@ -0,0 +1,41 @@
+#ifndef STACKS_HPP
+#define STACKS_HPP
+#include <lldb/API/LLDB.h>
+#include <string>
+#include <vector>
+
+// Backtraces of every thread at a stop, with identical ones collapsed into a
+//   single group (like pstack / parallel stacks)
+class Stacks {
+  public:
+    static constexpr uint32_t MaxDepth = 256;
+
+    struct Frame {
+      lldb::addr_t pc;
+      std::string label; // function and file:line when there's debug info
+    };
+    struct Group {
+      uint64_t hash;
+      std::vector<lldb::addr_t> pcs; // leaf first
+      std::vector<Frame> frames;
+      std::vector<uint32_t> thread_ids; // LLDB index ids
+      std::string threads_label;
+    };
+    struct Snapshot {
+      uint32_t stop_id = 0;
+      size_t thread_count = 0;
+      size_t worker_count = 0;
+      float collect_ms = 0.f; // unwinding and hashing
+      float group_ms = 0.f;   // grouping and symbolizing
+      std::vector<Group> groups; // largest first
+    };
+
+  public:
+    // Must be called while the process is stopped. Unwinds on up to max_workers
+    //   threads, 0 picks from the hardware concurrency
+    static Snapshot Collect(lldb::SBProcess process, size_t max_workers = 0);
+    // "function at file:line" for a pc, leaf is false for return addresses
+    static std::string Symbolize(lldb::SBTarget& target, lldb::addr_t pc, bool leaf);
+};
+
+#endif
@@ -0,0 +1,55 @@
+#include "StopLatency.hpp"
+
+std::mutex StopLatency::mutex = {};
+uint64_t StopLatency::stopCount = 0;
+uint64_t StopLatency::handedOffCount = 0;
+StopLatency::Clock::time_point StopLatency::stoppedAt = {};
+StopLatency::Clock::time_point StopLatency::handedOffStoppedAt = {};
+StopLatency::History StopLatency::handOffMs = {};
+StopLatency::History StopLatency::presentMs = {};
+uint64_t StopLatency::frameStop = 0;
+StopLatency::Clock::time_point StopLatency::frameStoppedAt = {};
+uint64_t StopLatency::presentedStop = 0;
+
+void StopLatency::MarkStopped() {
+  std::lock_guard lock(mutex);
+  stopCount++;
+  stoppedAt = Clock::now();
+}
+
+void StopLatency::MarkHandedOff() {
+  std::lock_guard lock(mutex);
+  if (handedOffCount == stopCount) return;
+  handedOffCount = stopCount;
+  handedOffStoppedAt = stoppedAt;
+  handOffMs.Push(std::chrono::duration<float, std::milli>(Clock::now() - stoppedAt).count());
+}
+
+void StopLatency::FrameStarted() {
+  std::lock_guard lock(mutex);
+  frameStop = handedOffCount;
+  frameStoppedAt = handedOffStoppedAt;
+}
+
+void StopLatency::FramePresented() {
+  std::lock_guard lock(mutex);
+  // Only a frame that began after the hand off can show the new state
+  if (frameStop == presentedStop) return;
+  presentedStop = frameStop;
+  presentMs.Push(std::chrono::duration<float, std::milli>(Clock::now() - frameStoppedAt).count());
+}
+
+uint64_t StopLatency::GetHandedOffCount() {
+  std::lock_guard lock(mutex);
+  return handedOffCount;
+}
+
+StopLatency::History StopLatency::GetHandOffHistory() {
+  std::lock_guard lock(mutex);
+  return handOffMs;
+}
+
+StopLatency::History StopLatency::GetPresentHistory() {
+  std::lock_guard lock(mutex);
+  return presentMs;
+}
@@ -0,0 +1,44 @@
+#ifndef STOP_LATENCY_HPP
+#define STOP_LATENCY_HPP
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include "RingBuffer.hpp"
+
+// Measures how long it takes from LLDB reporting a stop until the user sees it.
+//   Stopped: eStateStopped arrives on the event thread
+//   HandedOff: active line set and SwitchToFile sent to the UI
+//   Presented: first frame started after the hand off has been swapped
+class StopLatency {
+  public:
+    using Clock = std::chrono::steady_clock;
+    static constexpr size_t HistoryLength = 512;
+    using History = RingBuffer<float, HistoryLength>;
+
+  public:
+    static void MarkStopped();
+    static void MarkHandedOff();
+    static void FrameStarted();
+    static void FramePresented();
+
+    static uint64_t GetHandedOffCount();
+    // Copies, since the histories are written from the event thread
+    static History GetHandOffHistory();
+    static History GetPresentHistory();
+
+  private:
+    static std::mutex mutex;
+    static uint64_t stopCount;
+    static uint64_t handedOffCount;
+    static Clock::time_point stoppedAt;
+    static Clock::time_point handedOffStoppedAt;
+    static History handOffMs;
+    static History presentMs;
+
+    // UI thread only
+    static uint64_t frameStop;
+    static Clock::time_point frameStoppedAt;
+    static uint64_t presentedStop;
+};
+
+#endif
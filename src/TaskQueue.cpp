@@ -0,0 +1,46 @@
+#include "TaskQueue.hpp"
+#include "Trace.hpp"
+
+TaskQueue::TaskQueue(const std::string& name) {
+  worker = std::thread([this, name]() {
+    Trace::SetThreadName(name);
+    WorkerThread();
+  });
+}
+
+TaskQueue::~TaskQueue() {
+  Stop();
+}
+
+void TaskQueue::Push(std::function<void()> task) {
+  {
+    std::lock_guard lock(mutex);
+    if (stopping) return;
+    tasks.push(std::move(task));
+  }
+  cv.notify_one();
+}
+
+void TaskQueue::Stop() {
+  {
+    std::lock_guard lock(mutex);
+    stopping = true;
+  }
+  cv.notify_one();
+  if (worker.joinable())
+    worker.join();
+}
+
+void TaskQueue::WorkerThread() {
+  while (true) {
+    std::function<void()> task;
+    {
+      std::unique_lock lock(mutex);
+      cv.wait(lock, [this]() { return stopping || !tasks.empty(); });
+      if (stopping) return;
+      task = std::move(tasks.front());
+      tasks.pop();
+    }
+    task();
+  }
+}
@@ -0,0 +1,30 @@
+#ifndef TASK_QUEUE_HPP
+#define TASK_QUEUE_HPP
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+
+// Runs pushed tasks in order on a single background thread. Used to keep
+//   slow debugger queries off the event and UI threads.
+class TaskQueue {
+  public:
+    TaskQueue(const std::string& name = "Task Queue");
+    ~TaskQueue();
+    void Push(std::function<void()> task);
+    void Stop();
+
+  private:
+    void WorkerThread();
+
+  private:
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::queue<std::function<void()>> tasks;
+    bool stopping = false;
+};
+
+#endif
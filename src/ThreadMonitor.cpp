@@ -0,0 +1,182 @@
+#include "ThreadMonitor.hpp"
+#include "Logger.hpp"
+#include "Trace.hpp"
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <fmt/core.h>
+
+ThreadMonitor::~ThreadMonitor() {
+  Stop();
+}
+
+void ThreadMonitor::Start(int _pid, int rate_hz) {
+  Stop();
+  if (!ProcFS::IsSupported()) {
+    Logger::Warn("Thread monitor needs /proc, it is only available on Linux");
+    return;
+  }
+  pid = _pid;
+  SetRate(rate_hz);
+  tasks.clear();
+  sampleCount = 0;
+  {
+    std::lock_guard lock(mutex);
+    published.reset();
+  }
+  running = true;
+  thread = std::thread([this]() {
+    Trace::SetThreadName("Thread Monitor");
+    MonitorThread();
+  });
+  Logger::Info("Monitoring threads of pid {} at {} Hz", pid, rate.load());
+}
+
+void ThreadMonitor::Stop() {
+  running = false;
+  if (thread.joinable())
+    thread.join();
+}
+
+bool ThreadMonitor::IsRunning() const {
+  return running;
+}
+
+void ThreadMonitor::SetRate(int rate_hz) {
+  rate = std::clamp(rate_hz, MinRate, MaxRate);
+}
+
+int ThreadMonitor::GetRate() const {
+  return rate;
+}
+
+std::shared_ptr<const ThreadMonitor::Snapshot> ThreadMonitor::GetSnapshot() {
+  std::lock_guard lock(mutex);
+  return published;
+}
+
+void ThreadMonitor::MonitorThread() {
+  using clock = std::chrono::steady_clock;
+  auto next = clock::now();
+  auto last = next;
+  auto nextRefresh = next;
+  while (running) {
+    auto now = clock::now();
+    if (now >= nextRefresh) {
+      if (!RefreshTasks()) {
+        Logger::Info("Thread monitor: pid {} is gone", pid);
+        Publish(0.f, true);
+        running = false;
+        break;
+      }
+      nextRefresh = now + std::chrono::seconds(1);
+    }
+
+    auto start = clock::now();
+    Sample(std::chrono::duration<float>(start - last).count());
+    auto end = clock::now();
+    last = start;
+    Publish(std::chrono::duration<float, std::micro>(end - start).count(), false);
+
+    next += std::chrono::microseconds(1'000'000 / rate);
+    if (next < end) next = end;
+    std::this_thread::sleep_until(next);
+  }
+}
+
+bool ThreadMonitor::RefreshTasks() {
+  Trace::Scope t("Refresh Tasks", "monitor");
+  if (!ProcFS::ListTasks(pid, tids))
+    return false;
+
+  for (auto& [tid, task] : tasks)
+    task.alive = false;
+  for (int tid : tids) {
+    auto [it, inserted] = tasks.try_emplace(tid);
+    auto& task = it->second;
+    task.alive = true;
+    if (!inserted) continue;
+    auto base = fmt::format("/proc/{}/task/{}/", pid, tid);
+    if (!task.stat.Open(base + "stat")) {
+      tasks.erase(it);
+      continue;
+    }
+    // Only stat keeps an fd, a few hundred threads would use up the limit
+    task.status.Open(base + "status", false);
+    task.wchan_file.Open(base + "wchan", false);
+    task.thread.tid = tid;
+    task.thread.processor = -1;
+  }
+  std::erase_if(tasks, [](const auto& entry) { return !entry.second.alive; });
+  return true;
+}
+
+void ThreadMonitor::Sample(float elapsed_s) {
+  Trace::Scope t("Sample Threads", "monitor");
+  const uint64_t ticks_per_second = ProcFS::TicksPerSecond();
+  // wchan and status change less often and cost more to read
+  const bool read_wchan = sampleCount % 4 == 0;
+  const bool read_status = sampleCount % 8 == 0;
+  sampleCount++;
+
+  for (auto& [tid, task] : tasks) {
+    auto& thread = task.thread;
+    long n = task.stat.Read(buffer, sizeof(buffer));
+    ProcFS::Stat stat;
+    if (n <= 0 || !ProcFS::ParseStat(std::string_view(buffer, n), stat)) {
+      // Exited since the last refresh, gets dropped on the next one
+      thread.state = 'X';
+      continue;
+    }
+
+    if (thread.name.size() != stat.comm.size() || thread.name != stat.comm)
+      thread.name = stat.comm;
+    thread.state = stat.state;
+    thread.processor = stat.processor;
+    uint64_t ticks = stat.utime + stat.stime;
+    if (task.has_ticks && elapsed_s > 0.f)
+      thread.cpu = 100.f * (float)(ticks - task.ticks) / (float)ticks_per_second / elapsed_s;
+    task.ticks = ticks;
+    task.has_ticks = true;
+    thread.cpu_history.Push(thread.cpu);
+
+    if (read_wchan) {
+      if (thread.state == 'S' || thread.state == 'D') {
+        n = task.wchan_file.Read(buffer, sizeof(buffer));
+        if (n > 0) thread.wchan.assign(buffer, n);
+      }
+      else {
+        thread.wchan.clear();
+      }
+    }
+    if (read_status) {
+      n = task.status.Read(buffer, sizeof(buffer));
+      if (n > 0) {
+        std::string_view text(buffer, n);
+        auto voluntary = ProcFS::FindField(text, "voluntary_ctxt_switches");
+        auto involuntary = ProcFS::FindField(text, "nonvoluntary_ctxt_switches");
+        std::from_chars(voluntary.data(), voluntary.data() + voluntary.size(), thread.voluntary_switches);
+        std::from_chars(involuntary.data(), involuntary.data() + involuntary.size(), thread.involuntary_switches);
+      }
+    }
+  }
+}
+
+void ThreadMonitor::Publish(float sample_us, bool ended) {
+  auto snapshot = std::make_shared<Snapshot>();
+  snapshot->threads.reserve(tasks.size());
+  for (const auto& [tid, task] : tasks) {
+    snapshot->threads.push_back(task.thread);
+    snapshot->process_cpu += task.thread.cpu;
+    snapshot->cached_files += task.stat.IsCached();
+  }
+  std::sort(snapshot->threads.begin(), snapshot->threads.end(), [](const Thread& a, const Thread& b) {
+    return a.cpu != b.cpu ? a.cpu > b.cpu : a.tid < b.tid;
+  });
+  snapshot->sample_us = sample_us;
+  snapshot->samples = sampleCount;
+  snapshot->ended = ended;
+
+  std::lock_guard lock(mutex);
+  published = std::move(snapshot);
+}
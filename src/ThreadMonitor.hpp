@@ -0,0 +1,85 @@
+#ifndef THREAD_MONITOR_HPP
+#define THREAD_MONITOR_HPP
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "ProcFS.hpp"
+#include "RingBuffer.hpp"
+
+// Watches the threads of a process through /proc/<pid>/task without stopping
+//   it. stat is read every sample, wchan (for sleeping threads) and status
+//   every few samples, the task list about once a second.
+class ThreadMonitor {
+  public:
+    static constexpr int MinRate = 1;
+    static constexpr int MaxRate = 50;
+    static constexpr size_t HistoryLength = 60;
+    using History = RingBuffer<float, HistoryLength>;
+
+    struct Thread {
+      int tid;
+      std::string name;
+      char state;
+      int processor;
+      float cpu; // percent of one core
+      History cpu_history;
+      std::string wchan;
+      uint64_t voluntary_switches;
+      uint64_t involuntary_switches;
+    };
+    struct Snapshot {
+      std::vector<Thread> threads; // busiest first
+      float process_cpu = 0.f;
+      float sample_us = 0.f;
+      size_t cached_files = 0; // stat files read through a kept open fd
+      uint64_t samples = 0;
+      bool ended = false;
+    };
+
+  public:
+    ~ThreadMonitor();
+    void Start(int pid, int rate_hz);
+    void Stop();
+    bool IsRunning() const;
+    void SetRate(int rate_hz);
+    int GetRate() const;
+    std::shared_ptr<const Snapshot> GetSnapshot();
+
+  private:
+    struct Task {
+      ProcFS::File stat;
+      ProcFS::File status;
+      ProcFS::File wchan_file;
+      Thread thread{};
+      uint64_t ticks = 0;
+      bool has_ticks = false;
+      bool alive = true;
+    };
+
+  private:
+    void MonitorThread();
+    bool RefreshTasks();
+    void Sample(float elapsed_s);
+    void Publish(float sample_us, bool ended);
+
+  private:
+    std::thread thread;
+    std::atomic<bool> running = false;
+    std::atomic<int> rate = 10;
+    int pid = 0;
+
+    std::mutex mutex;
+    std::shared_ptr<const Snapshot> published;
+
+    // Monitor thread only
+    std::unordered_map<int, Task> tasks;
+    std::vector<int> tids;
+    uint64_t sampleCount = 0;
+    char buffer[4096];
+};
+
+#endif
@@ -0,0 +1,136 @@
+#include "Trace.hpp"
+#include "Logger.hpp"
+#include <fstream>
+#include <fmt/format.h>
+
+std::atomic<bool> Trace::enabled = false;
+std::mutex Trace::buffersMutex = {};
+std::vector<std::unique_ptr<Trace::ThreadBuffer>> Trace::buffers = {};
+uint32_t Trace::nextTid = 1;
+const Trace::Clock::time_point Trace::epoch = Trace::Clock::now();
+thread_local Trace::ThreadBufferOwner Trace::threadBuffer = {};
+
+Trace::ThreadBufferOwner::~ThreadBufferOwner() {
+  if (!buffer) return;
+  std::lock_guard lock(buffersMutex);
+  buffer->exited = true;
+  buffer = nullptr;
+}
+
+Trace::Scope::Scope(const char* name, const char* category):
+  name(name),
+  category(category),
+  active(Trace::IsEnabled())
+{
+  if (active)
+    start = Clock::now();
+}
+
+Trace::Scope::~Scope() {
+  if (active)
+    Trace::Record(name, category, start, Clock::now());
+}
+
+void Trace::SetEnabled(bool _enabled) {
+  enabled.store(_enabled, std::memory_order_relaxed);
+  Logger::Info("Tracing {}", _enabled ? "enabled" : "disabled");
+}
+
+bool Trace::IsEnabled() {
+  return enabled.load(std::memory_order_relaxed);
+}
+
+void Trace::SetThreadName(const std::string& name) {
+  auto& buffer = GetThreadBuffer();
+  std::lock_guard lock(buffersMutex);
+  buffer.name = name;
+}
+
+void Trace::Record(const char* name, const char* category, Clock::time_point start, Clock::time_point end) {
+  if (!IsEnabled()) return;
+  auto& buffer = GetThreadBuffer();
+  if (!buffer.events) {
+    // Only this thread sets it, the lock is for a concurrent dump
+    std::lock_guard lock(buffersMutex);
+    buffer.events = std::make_unique<Event[]>(ThreadBuffer::Capacity);
+  }
+  uint64_t index = buffer.written.load(std::memory_order_relaxed);
+  auto& event = buffer.events[index % ThreadBuffer::Capacity];
+  event.name.store(name, std::memory_order_relaxed);
+  event.category.store(category, std::memory_order_relaxed);
+  event.start_us.store(ToMicroseconds(start), std::memory_order_relaxed);
+  event.duration_us.store(std::chrono::duration_cast<std::chrono::microseconds>(end - start).count(), std::memory_order_relaxed);
+  buffer.written.store(index + 1, std::memory_order_release);
+}
+
+bool Trace::Dump(const std::filesystem::path& path) {
+  Logger::ScopedGroup g("Trace::Dump");
+  fmt::memory_buffer out;
+  fmt::format_to(std::back_inserter(out), "{{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+  size_t event_count = 0;
+  bool first = true;
+  {
+    std::lock_guard lock(buffersMutex);
+    for (const auto& buffer : buffers) {
+      if (!buffer->name.empty()) {
+        fmt::format_to(std::back_inserter(out), "{}{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":{},\"args\":{{\"name\":\"{}\"}}}}",
+          first ? "" : ",\n", buffer->tid, buffer->name);
+        first = false;
+      }
+      if (!buffer->events) continue;
+
+      uint64_t written = buffer->written.load(std::memory_order_acquire);
+      uint64_t begin = written > ThreadBuffer::Capacity ? written - ThreadBuffer::Capacity : 0;
+      for (uint64_t i = begin; i < written; i++) {
+        const auto& event = buffer->events[i % ThreadBuffer::Capacity];
+        const char* name = event.name.load(std::memory_order_relaxed);
+        const char* category = event.category.load(std::memory_order_relaxed);
+        int64_t start_us = event.start_us.load(std::memory_order_relaxed);
+        int64_t duration_us = event.duration_us.load(std::memory_order_relaxed);
+        // The owner kept recording while we copied, drop the slot if it was reused
+        if (buffer->written.load(std::memory_order_acquire) - i > ThreadBuffer::Capacity) continue;
+
+        fmt::format_to(std::back_inserter(out), "{}{{\"name\":\"{}\",\"cat\":\"{}\",\"ph\":\"X\",\"ts\":{},\"dur\":{},\"pid\":1,\"tid\":{}}}",
+          first ? "" : ",\n", name, category, start_us, duration_us, buffer->tid);
+        first = false;
+        event_count++;
+      }
+    }
+  }
+  fmt::format_to(std::back_inserter(out), "\n]}}\n");
+
+  std::ofstream f(path, std::ios::binary);
+  if (!f.is_open()) {
+    Logger::Err("Failed to open {} for writing", path.string());
+    return false;
+  }
+  f.write(out.data(), out.size());
+  Logger::Info("Wrote {} trace events to {}", event_count, path.string());
+  return true;
+}
+
+Trace::ThreadBuffer& Trace::GetThreadBuffer() {
+  if (!threadBuffer.buffer) {
+    std::lock_guard lock(buffersMutex);
+    // Reuse an exited thread's buffer and its events allocation
+    ThreadBuffer* buffer = nullptr;
+    for (auto& b : buffers) {
+      if (b->exited) {
+        buffer = b.get();
+        break;
+      }
+    }
+    if (!buffer)
+      buffer = buffers.emplace_back(std::make_unique<ThreadBuffer>()).get();
+    buffer->written.store(0, std::memory_order_relaxed);
+    buffer->tid = nextTid++;
+    buffer->name.clear();
+    buffer->exited = false;
+    threadBuffer.buffer = buffer;
+  }
+  return *threadBuffer.buffer;
+}
+
+int64_t Trace::ToMicroseconds(Clock::time_point time) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(time - epoch).count();
+}
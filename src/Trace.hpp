@@ -0,0 +1,76 @@
+#ifndef TRACE_HPP
+#define TRACE_HPP
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Timeline tracing that can be dumped as Chrome Trace Event JSON (loadable in
+//   chrome://tracing and Perfetto). Every thread writes spans into its own ring
+//   buffer, so recording takes no locks. Names must be string literals.
+class Trace {
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    class Scope {
+      public:
+        Scope(const char* name, const char* category = "app");
+        ~Scope();
+      private:
+        const char* name;
+        const char* category;
+        Clock::time_point start;
+        bool active;
+    };
+
+  public:
+    static void SetEnabled(bool enabled);
+    static bool IsEnabled();
+    static void SetThreadName(const std::string& name);
+    static void Record(const char* name, const char* category, Clock::time_point start, Clock::time_point end);
+    static bool Dump(const std::filesystem::path& path);
+
+  private:
+    // Fields are atomics so a dump can read slots the owning thread may be
+    //   overwriting. A slot is only kept if it wasn't lapped while being copied.
+    struct Event {
+      std::atomic<const char*> name;
+      std::atomic<const char*> category;
+      std::atomic<int64_t> start_us;
+      std::atomic<int64_t> duration_us;
+    };
+    // Events are allocated on the first record, so threads that never record
+    //   cost nothing. When a thread exits its buffer stays readable until a
+    //   new thread takes it over, which keeps per stop workers from piling up
+    struct ThreadBuffer {
+      static constexpr size_t Capacity = 1 << 16;
+      std::unique_ptr<Event[]> events;
+      std::atomic<uint64_t> written = 0;
+      uint32_t tid = 0;
+      std::string name;
+      bool exited = false;
+    };
+    // Hands the buffer back when its thread exits
+    struct ThreadBufferOwner {
+      ThreadBuffer* buffer = nullptr;
+      ~ThreadBufferOwner();
+    };
+
+  private:
+    static ThreadBuffer& GetThreadBuffer();
+    static int64_t ToMicroseconds(Clock::time_point time);
+
+  private:
+    static std::atomic<bool> enabled;
+    static std::mutex buffersMutex;
+    static std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    static uint32_t nextTid;
+    static const Clock::time_point epoch;
+    static thread_local ThreadBufferOwner threadBuffer;
+};
+
+#endif
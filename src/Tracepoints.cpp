@@ -0,0 +1,132 @@
+#include "Tracepoints.hpp"
+#include "Logger.hpp"
+#include "Trace.hpp"
+#include <algorithm>
+#include <fmt/format.h>
+
+lldb::break_id_t Tracepoints::Add(lldb::SBTarget target, const std::string& file, int line, const std::string& message) {
+  lldb::SBBreakpoint bp = target.BreakpointCreateByLocation(file.c_str(), line);
+  if (!bp.IsValid()) {
+    Logger::Err("Failed to set tracepoint at {}:{}", file, line);
+    return LLDB_INVALID_BREAK_ID;
+  }
+
+  auto tracepoint = std::make_unique<Tracepoint>();
+  tracepoint->owner = this;
+  tracepoint->id = bp.GetID();
+  tracepoint->location = fmt::format("{}:{}", file, line);
+  tracepoint->message = message;
+  tracepoint->segments = ParseMessage(message);
+  bp.SetCallback(&Tracepoints::OnHit, tracepoint.get());
+
+  std::lock_guard lock(mutex);
+  Logger::Info("Tracepoint {} at {}: \"{}\"", tracepoint->id, tracepoint->location, message);
+  auto id = tracepoint->id;
+  tracepoints[id] = std::move(tracepoint);
+  return id;
+}
+
+bool Tracepoints::Remove(lldb::SBTarget target, lldb::break_id_t id) {
+  std::lock_guard lock(mutex);
+  auto it = tracepoints.find(id);
+  if (it == tracepoints.end()) return false;
+  target.BreakpointDelete(id);
+  retired.push_back(std::move(it->second));
+  tracepoints.erase(it);
+  return true;
+}
+
+std::vector<Tracepoints::Info> Tracepoints::GetTracepoints() {
+  std::lock_guard lock(mutex);
+  std::vector<Info> infos;
+  infos.reserve(tracepoints.size());
+  for (const auto& [id, tracepoint] : tracepoints)
+    infos.push_back(Info{id, tracepoint->location, tracepoint->message, tracepoint->hits.load(std::memory_order_relaxed)});
+  std::sort(infos.begin(), infos.end(), [](const Info& a, const Info& b) { return a.id < b.id; });
+  return infos;
+}
+
+uint64_t Tracepoints::GetTotalHits() const {
+  return totalHits.load(std::memory_order_relaxed);
+}
+
+std::vector<Tracepoints::Segment> Tracepoints::ParseMessage(const std::string& message) {
+  // "{{" and "}}" are literal braces, "{path}" a variable path
+  std::vector<Segment> segments;
+  std::string literal;
+  for (size_t i = 0; i < message.size(); i++) {
+    char c = message[i];
+    if ((c == '{' || c == '}') && i + 1 < message.size() && message[i + 1] == c) {
+      literal += c;
+      i++;
+      continue;
+    }
+    size_t close = c == '{' ? message.find('}', i) : std::string::npos;
+    if (close == std::string::npos) {
+      literal += c;
+      continue;
+    }
+    if (!literal.empty())
+      segments.push_back(Segment{false, std::move(literal)});
+    literal.clear();
+    segments.push_back(Segment{true, message.substr(i + 1, close - i - 1)});
+    i = close;
+  }
+  if (!literal.empty())
+    segments.push_back(Segment{false, std::move(literal)});
+  return segments;
+}
+
+bool Tracepoints::OnHit(void* baton, lldb::SBProcess& process, lldb::SBThread& thread, lldb::SBBreakpointLocation& location) {
+  auto tracepoint = static_cast<Tracepoint*>(baton);
+  tracepoint->hits.fetch_add(1, std::memory_order_relaxed);
+  tracepoint->owner->totalHits.fetch_add(1, std::memory_order_relaxed);
+
+  lldb::SBFrame frame = thread.GetFrameAtIndex(0);
+  fmt::memory_buffer buffer;
+  fmt::format_to(std::back_inserter(buffer), "[{}] {}: ", thread.GetIndexID(), tracepoint->location);
+  for (const auto& segment : tracepoint->segments) {
+    if (!segment.is_path) {
+      buffer.append(segment.text);
+      continue;
+    }
+    lldb::SBValue value = frame.GetValueForVariablePath(segment.text.c_str());
+    const char* text = nullptr;
+    if (value.IsValid())
+      text = value.GetValue() ? value.GetValue() : value.GetSummary();
+    buffer.append(std::string_view(text ? text : "<unavailable>"));
+  }
+  tracepoint->owner->PushLogLine(fmt::to_string(buffer));
+
+  // Don't stop
+  return false;
+}
+
+void Tracepoints::PushLogLine(std::string line) {
+  std::lock_guard lock(logMutex);
+  log[logCount % LogCapacity] = std::move(line);
+  logCount++;
+}
+
+uint64_t Tracepoints::GetLogLineCount() {
+  std::lock_guard lock(logMutex);
+  return logCount;
+}
+
+uint64_t Tracepoints::GetFirstLogLine() {
+  std::lock_guard lock(logMutex);
+  return logCount > LogCapacity ? logCount - LogCapacity : 0;
+}
+
+void Tracepoints::CopyLogLines(uint64_t first, size_t count, std::vector<std::string>& out) {
+  std::lock_guard lock(logMutex);
+  out.clear();
+  uint64_t oldest = logCount > LogCapacity ? logCount - LogCapacity : 0;
+  for (uint64_t i = std::max<uint64_t>(first, oldest); i < first + count && i < logCount; i++)
+    out.push_back(log[i % LogCapacity]);
+}
+
+void Tracepoints::ClearLog() {
+  std::lock_guard lock(logMutex);
+  logCount = 0;
+}
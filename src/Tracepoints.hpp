@@ -0,0 +1,72 @@
+#ifndef TRACEPOINTS_HPP
+#define TRACEPOINTS_HPP
+#include <lldb/API/LLDB.h>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Breakpoints that log a message and keep going. The message is formatted in
+//   the breakpoint callback on LLDB's own thread, which then declines the stop,
+//   so a hit never reaches the event thread or the UI.
+//   Messages are templates, "{path}" is replaced with the value of a variable
+//   path in the stopped frame, e.g. "x = {x}, size = {v.size}"
+class Tracepoints {
+  public:
+    static constexpr size_t LogCapacity = 1 << 14;
+
+    struct Info {
+      lldb::break_id_t id;
+      std::string location;
+      std::string message;
+      uint64_t hits;
+    };
+
+  public:
+    lldb::break_id_t Add(lldb::SBTarget target, const std::string& file, int line, const std::string& message);
+    bool Remove(lldb::SBTarget target, lldb::break_id_t id);
+    std::vector<Info> GetTracepoints();
+    uint64_t GetTotalHits() const;
+
+    // Lines are numbered from 0 since the last clear, only the last LogCapacity
+    //   are kept
+    uint64_t GetLogLineCount();
+    uint64_t GetFirstLogLine();
+    void CopyLogLines(uint64_t first, size_t count, std::vector<std::string>& out);
+    void ClearLog();
+
+  private:
+    struct Segment {
+      bool is_path;
+      std::string text;
+    };
+    struct Tracepoint {
+      Tracepoints* owner;
+      lldb::break_id_t id;
+      std::string location;
+      std::string message;
+      std::vector<Segment> segments;
+      std::atomic<uint64_t> hits = 0;
+    };
+
+  private:
+    static std::vector<Segment> ParseMessage(const std::string& message);
+    static bool OnHit(void* baton, lldb::SBProcess& process, lldb::SBThread& thread, lldb::SBBreakpointLocation& location);
+    void PushLogLine(std::string line);
+
+  private:
+    std::mutex mutex;
+    std::unordered_map<lldb::break_id_t, std::unique_ptr<Tracepoint>> tracepoints;
+    // LLDB may be inside a callback with the baton while a tracepoint is being
+    //   removed, so removed ones are kept around
+    std::vector<std::unique_ptr<Tracepoint>> retired;
+    std::atomic<uint64_t> totalHits = 0;
+
+    std::mutex logMutex;
+    std::vector<std::string> log = std::vector<std::string>(LogCapacity);
+    uint64_t logCount = 0;
+};
+
+#endif
@@ -1,8 +1,14 @@
 #include "Util.hpp"
 #include "FileContext.hpp"
 #include "Logger.hpp"
+#include "ConcurrentSet.hpp"
+#include "Trace.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <iostream>
 #include <fstream>
+#include <thread>
 #if defined(_WIN32)
 #include <windows.h>
 #elif defined(__APPLE__)
@@ -51,6 +57,89 @@ namespace Util {
     }
   }
 
+  std::vector<std::filesystem::path> GetModulesSourceFiles(std::vector<lldb::SBModule>& modules) {
+    Logger::ScopedGroup g("GetModulesSourceFiles");
+    Trace::Scope t("Enumerate Compile Units", "target");
+    using clock = std::chrono::steady_clock;
+    auto start = clock::now();
+
+    // Flatten to (module, compile unit) pairs so one huge module and many small
+    //   ones spread evenly over the workers
+    std::vector<std::pair<uint32_t, uint32_t>> units;
+    for (uint32_t i = 0; i < modules.size(); i++) {
+      if (!modules[i].IsValid()) continue;
+      const uint32_t cu_count = modules[i].GetNumCompileUnits();
+      for (uint32_t j = 0; j < cu_count; j++)
+        units.emplace_back(i, j);
+    }
+
+    const size_t hardware_threads = std::thread::hardware_concurrency();
+    const size_t thread_count = std::clamp<size_t>(units.size() / 64, 1, hardware_threads ? hardware_threads : 1);
+
+    ConcurrentSet<std::string> seen;
+    std::atomic<size_t> next_unit = 0;
+    std::atomic<size_t> support_file_count = 0;
+    std::atomic<int64_t> support_file_ns = 0;
+    std::vector<std::vector<std::filesystem::path>> thread_files(thread_count);
+
+    auto worker = [&](size_t thread_index) {
+      auto& files = thread_files[thread_index];
+      size_t local_support_count = 0;
+      clock::duration local_support_time{};
+
+      auto add_file_spec = [&](const lldb::SBFileSpec& fs) {
+        auto directory = fs.GetDirectory();
+        auto name = fs.GetFilename();
+        if (!name || !directory) return false;
+        auto path = std::filesystem::path(directory) / name;
+        if (seen.Insert(path.string()))
+          files.push_back(std::move(path));
+        return true;
+      };
+
+      for (size_t u; (u = next_unit.fetch_add(1, std::memory_order_relaxed)) < units.size();) {
+        auto [module_index, cu_index] = units[u];
+        lldb::SBCompileUnit cu = modules[module_index].GetCompileUnitAtIndex(cu_index);
+        auto fs = cu.GetFileSpec();
+        //NOTE: This is a temporary fix for a null pointer dereference
+        // crash on windows
+        if (!add_file_spec(fs)) {
+          Logger::Crit("Something went wrong. directory = '{}', name = '{}'", fs.GetDirectory() ? fs.GetDirectory() : "null", fs.GetFilename() ? fs.GetFilename() : "null");
+        }
+
+        // Headers and other files referenced by the line table. Entries without
+        //   a directory (e.g. <built-in>) can't be opened so they're skipped
+        auto support_start = clock::now();
+        const uint32_t support_count = cu.GetNumSupportFiles();
+        for (uint32_t k = 0; k < support_count; k++)
+          add_file_spec(cu.GetSupportFileAtIndex(k));
+        local_support_time += clock::now() - support_start;
+        local_support_count += support_count;
+      }
+
+      support_file_count += local_support_count;
+      support_file_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(local_support_time).count();
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < thread_count; i++)
+      threads.emplace_back(worker, i);
+    worker(0);
+    for (auto& thread : threads)
+      thread.join();
+
+    std::vector<std::filesystem::path> files;
+    for (auto& thread_file : thread_files)
+      files.insert(files.end(), std::make_move_iterator(thread_file.begin()), std::make_move_iterator(thread_file.end()));
+
+    auto elapsed_ms = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+    Logger::Info("{} compile units in {} modules -> {} unique files in {:.2f} ms on {} threads",
+      units.size(), modules.size(), files.size(), elapsed_ms, thread_count);
+    Logger::Info("Support files: {} entries, {:.2f} ms of worker time",
+      support_file_count.load(), support_file_ns.load() / 1e6);
+    return files;
+  }
+
   std::filesystem::path GetCurrentProgramDirectory() {
     std::filesystem::path exePath;
 
@@ -14,6 +14,7 @@ namespace Util {
 
   void PrintTargetModules(lldb::SBTarget& target);
   void PrintModuleCompileUnits(lldb::SBTarget& target, int moduleIdx);
+  std::vector<std::filesystem::path> GetModulesSourceFiles(std::vector<lldb::SBModule>& modules);
   std::filesystem::path GetCurrentProgramDirectory();
   std::string StringEscapeBackslash(const std::string& string);
   std::optional<std::filesystem::path> GetTargetSourceRootDirectory(std::filesystem::path start_dir);
@@ -0,0 +1,112 @@
+#include "ValueDiff.hpp"
+#include "Formatters.hpp"
+#include "Trace.hpp"
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <fmt/core.h>
+
+namespace {
+  uint64_t Hash(std::string_view text, uint64_t hash = 0xcbf29ce484222325ull) {
+    for (char c : text)
+      hash = (hash ^ (uint8_t)c) * 0x100000001b3ull;
+    return hash;
+  }
+
+  // Same text as the Locals window shows, so a highlight always means a visible change
+  std::string_view ValueText(lldb::SBValue& value, std::optional<Formatters::Decoded>& decoded) {
+    if (auto kind = Formatters::Classify(value))
+      decoded = Formatters::Decode(*kind, value);
+    if (decoded) return decoded->summary;
+    const char* text = value.GetValue();
+    if (!text) text = value.GetSummary();
+    return text ? text : "";
+  }
+
+  void AddLocal(lldb::SBValue value, const std::string& path, uint32_t depth, std::vector<ValueDiff::Entry>& out) {
+    if (out.size() >= ValueDiff::MaxEntries) return;
+    std::optional<Formatters::Decoded> decoded;
+    out.push_back({ValueDiff::HashPath(path), Hash(ValueText(value, decoded))});
+    if (depth + 1 >= ValueDiff::MaxDepth) return;
+
+    const bool native = decoded && decoded->native_children;
+    if (decoded && !native && decoded->child_count == 0) return;
+    if (!decoded && !value.MightHaveChildren()) return;
+    const uint32_t count = native
+      ? (uint32_t)std::min<uint64_t>(decoded->child_count, ValueDiff::MaxChildren)
+      : value.GetNumChildren(ValueDiff::MaxChildren);
+    for (uint32_t i = 0; i < count && out.size() < ValueDiff::MaxEntries; i++) {
+      lldb::SBValue child = native ? Formatters::GetChild(*decoded, value, i) : value.GetChildAtIndex(i);
+      if (!child.IsValid()) continue;
+      const char* name = child.GetName();
+      AddLocal(child, fmt::format("{}.{}", path, name ? name : ""), depth + 1, out);
+    }
+  }
+
+  void SortByPath(std::vector<ValueDiff::Entry>& entries) {
+    std::sort(entries.begin(), entries.end(), [](const ValueDiff::Entry& a, const ValueDiff::Entry& b) { return a.path < b.path; });
+  }
+}
+
+uint64_t ValueDiff::HashPath(std::string_view path) {
+  return Hash(path);
+}
+
+bool ValueDiff::Changes::Contains(uint64_t path) const {
+  return std::binary_search(changed.begin(), changed.end(), path);
+}
+
+uint64_t ValueDiff::FrameKey(lldb::SBFrame& frame, lldb::SBTarget& target) {
+  return frame.GetFunction().GetStartAddress().GetLoadAddress(target) * 0x100000001b3ull ^ frame.GetCFA();
+}
+
+ValueDiff::Snapshot ValueDiff::Take(lldb::SBProcess process, uint32_t thread_index, uint32_t frame_id) {
+  Trace::Scope t("Value Snapshot", "diff");
+  Snapshot snapshot;
+  snapshot.stop_id = process.GetStopID();
+  snapshot.thread_index = thread_index;
+  snapshot.frame_id = frame_id;
+  lldb::SBFrame frame = process.GetThreadByIndexID(thread_index).GetFrameAtIndex(frame_id);
+  if (!frame.IsValid()) return snapshot;
+  lldb::SBTarget target = process.GetTarget();
+  snapshot.frame_key = FrameKey(frame, target);
+
+  lldb::SBValueList variables = frame.GetFrameBlock().GetVariables(frame, false, true, false, lldb::DynamicValueType::eNoDynamicValues);
+  for (uint32_t i = 0; i < variables.GetSize(); i++) {
+    lldb::SBValue variable = variables.GetValueAtIndex(i);
+    const char* name = variable.GetName();
+    AddLocal(variable, name ? name : "", 0, snapshot.locals);
+  }
+
+  SortByPath(snapshot.locals);
+  return snapshot;
+}
+
+void ValueDiff::Diff(const std::vector<Entry>& previous, const std::vector<Entry>& current, Changes& changes) {
+  // Both sorted by path, values that only exist on one side aren't changes
+  auto p = previous.begin();
+  for (const auto& entry : current) {
+    while (p != previous.end() && p->path < entry.path) ++p;
+    if (p == previous.end()) break;
+    if (p->path != entry.path) continue;
+    changes.compared++;
+    if (p->value != entry.value)
+      changes.changed.push_back(entry.path);
+  }
+}
+
+ValueDiff::Changes ValueDiff::Diff(const Snapshot& previous, const Snapshot& current) {
+  Trace::Scope t("Value Diff", "diff");
+  auto start = std::chrono::steady_clock::now();
+  Changes changes;
+  changes.stop_id = current.stop_id;
+  changes.thread_index = current.thread_index;
+  changes.frame_id = current.frame_id;
+  changes.frame_key = current.frame_key;
+  // In another call the locals are different variables under the same names
+  if (previous.frame_key == current.frame_key)
+    Diff(previous.locals, current.locals, changes);
+  std::sort(changes.changed.begin(), changes.changed.end());
+  changes.diff_ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+  return changes;
+}
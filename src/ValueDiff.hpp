@@ -0,0 +1,56 @@
+#ifndef VALUE_DIFF_HPP
+#define VALUE_DIFF_HPP
+#include <lldb/API/LLDB.h>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// Which locals changed between two stops. A snapshot keeps only
+//   a hash of each variable path and of its value, sorted by path, so the
+//   diff is a single merge and a large frame costs 16 bytes per value.
+//   Locals are only compared while the same function call is on top.
+//   Registers are diffed byte for byte by Registers instead
+class ValueDiff {
+  public:
+    // Bounds the snapshot for large frames, deeper or later values are skipped
+    static constexpr size_t MaxEntries = 16384;
+    static constexpr uint32_t MaxDepth = 3;
+    static constexpr uint32_t MaxChildren = 64;
+
+    struct Entry {
+      uint64_t path;
+      uint64_t value;
+    };
+    struct Snapshot {
+      uint32_t stop_id = UINT32_MAX;
+      uint32_t thread_index = UINT32_MAX;
+      uint32_t frame_id = UINT32_MAX;
+      uint64_t frame_key = 0; // function and CFA of the selected frame
+      std::vector<Entry> locals;
+    };
+    struct Changes {
+      uint32_t stop_id = 0;
+      uint32_t thread_index = 0;
+      uint32_t frame_id = 0;
+      uint64_t frame_key = 0;
+      std::vector<uint64_t> changed; // path hashes, sorted
+      size_t compared = 0;
+      float snapshot_ms = 0.f;
+      float diff_ms = 0.f;
+      bool Contains(uint64_t path) const;
+    };
+
+  public:
+    // Paths are the ones VariableTree builds ("v.child")
+    static uint64_t HashPath(std::string_view path);
+    // Identifies a function call: the function's address and the CFA
+    static uint64_t FrameKey(lldb::SBFrame& frame, lldb::SBTarget& target);
+    // Must be called while the process is stopped
+    static Snapshot Take(lldb::SBProcess process, uint32_t thread_index, uint32_t frame_id);
+    static Changes Diff(const Snapshot& previous, const Snapshot& current);
+
+  private:
+    static void Diff(const std::vector<Entry>& previous, const std::vector<Entry>& current, Changes& changes);
+};
+
+#endif
@@ -0,0 +1,113 @@
+#include "VariableTree.hpp"
+#include "Trace.hpp"
+#include "ValueDiff.hpp"
+#include <algorithm>
+#include <fmt/core.h>
+
+void VariableTree::Update(lldb::SBProcess process) {
+  if (!process.IsValid()) {
+    nodes.clear();
+    roots.clear();
+    stopId = UINT32_MAX;
+    frameKey = 0;
+    return;
+  }
+  if (process.GetState() != lldb::eStateStopped) return;
+  lldb::SBThread thread = process.GetSelectedThread();
+  lldb::SBFrame frame = thread.GetSelectedFrame();
+  const uint32_t stop_id = process.GetStopID();
+  if (stop_id == stopId && thread.GetIndexID() == threadId && frame.GetFrameID() == frameId)
+    return;
+
+  Trace::Scope t("Fetch Locals", "locals");
+  stopId = stop_id;
+  threadId = thread.GetIndexID();
+  frameId = frame.GetFrameID();
+  lldb::SBTarget target = process.GetTarget();
+  frameKey = ValueDiff::FrameKey(frame, target);
+  nodes.clear();
+  roots.clear();
+  lldb::SBValueList variables = frame.GetFrameBlock().GetVariables(frame, false, true, false, lldb::DynamicValueType::eNoDynamicValues);
+  for (uint32_t i = 0; i < variables.GetSize(); i++)
+    roots.push_back(AddNode(variables.GetValueAtIndex(i), {}));
+}
+
+void VariableTree::Invalidate() {
+  stopId = UINT32_MAX;
+}
+
+const std::vector<uint32_t>& VariableTree::GetRoots() const {
+  return roots;
+}
+
+VariableTree::Node& VariableTree::GetNode(uint32_t index) {
+  return nodes[index];
+}
+
+uint32_t VariableTree::GetStopId() const {
+  return stopId;
+}
+
+uint64_t VariableTree::GetFrameKey() const {
+  return frameKey;
+}
+
+size_t VariableTree::GetNodeCount() const {
+  return nodes.size();
+}
+
+uint32_t VariableTree::AddNode(lldb::SBValue value, std::string_view prefix) {
+  const char* name = value.GetName();
+  const char* type = value.GetTypeName();
+  Node node;
+  node.name = fmt::format("{}{}", prefix, name ? name : "");
+  node.path_hash = ValueDiff::HashPath(node.name);
+  // LLDB's summary and synthetic children are never asked for when a
+  //   built-in formatter can decode the value
+  if (auto kind = Formatters::Classify(value))
+    node.decoded = Formatters::Decode(*kind, value);
+  if (node.decoded) {
+    node.label = fmt::format("{} ({}) = {}", node.name, type ? type : "?", node.decoded->summary);
+    node.might_have_children = node.decoded->child_count > 0;
+  }
+  else {
+    const char* summary = value.GetValue();
+    if (!summary) summary = value.GetSummary();
+    node.label = fmt::format("{} ({}) = {}", node.name, type ? type : "?", summary ? summary : "<no value>");
+    // Unlike GetNumChildren() this never counts, which can walk a whole list
+    node.might_have_children = value.MightHaveChildren();
+  }
+  node.value = value;
+  nodes.push_back(std::move(node));
+  return (uint32_t)nodes.size() - 1;
+}
+
+void VariableTree::FetchPage(uint32_t index) {
+  Trace::Scope t("Fetch Children", "locals");
+  // Copied, AddNode below can reallocate nodes
+  lldb::SBValue value = nodes[index].value;
+  const std::string prefix = nodes[index].name + ".";
+  const uint32_t first = nodes[index].next_child;
+  const std::optional<Formatters::Decoded> decoded = nodes[index].decoded;
+  const bool native = decoded && decoded->native_children;
+  // Counting stops at the cap, so only one more than the page is asked for
+  const uint32_t available = native
+    ? (uint32_t)std::min<uint64_t>(decoded->child_count, UINT32_MAX)
+    : value.GetNumChildren(first + PageSize + 1);
+  const uint32_t last = std::min<uint32_t>(available, first + PageSize);
+
+  std::vector<uint32_t> children;
+  children.reserve(last > first ? last - first : 0);
+  for (uint32_t i = first; i < last; i++) {
+    lldb::SBValue child = native ? Formatters::GetChild(*decoded, value, i) : value.GetChildAtIndex(i);
+    if (child.IsValid())
+      children.push_back(AddNode(child, prefix));
+  }
+  Node& node = nodes[index];
+  if (first == 0)
+    node.array = ArrayView::Recognize(value);
+  node.children.insert(node.children.end(), children.begin(), children.end());
+  node.next_child = last;
+  node.has_more = available > last;
+  node.fetched = true;
+}
@@ -0,0 +1,62 @@
+#ifndef VARIABLE_TREE_HPP
+#define VARIABLE_TREE_HPP
+#include <lldb/API/LLDB.h>
+#include "ArrayView.hpp"
+#include "Formatters.hpp"
+#include <optional>
+#include <string>
+#include <vector>
+
+// The selected frame's variables as shown by the Locals window. Labels are
+//   built once per stop, and children are only fetched for expanded nodes, a
+//   page at a time, so a huge container is never walked in full
+class VariableTree {
+  public:
+    static constexpr uint32_t PageSize = 100;
+    static constexpr uint32_t InvalidNode = UINT32_MAX;
+
+    struct Node {
+      lldb::SBValue value;
+      std::string name;  // stable across stops, used as the ImGui id
+      uint64_t path_hash; // ValueDiff::HashPath(name)
+      std::string label; // "name (type) = value"
+      bool might_have_children;
+      bool has_more = false; // more children than the ones fetched
+      bool fetched = false;
+      uint32_t next_child = 0; // children that failed to fetch are skipped
+      // Set for arrays and vectors of scalars, which can be read in one go
+      std::optional<ArrayView::Source> array;
+      // Set when a built-in formatter decoded the value
+      std::optional<Formatters::Decoded> decoded;
+      std::vector<uint32_t> children;
+    };
+
+  public:
+    // Starts over when the stop or the selected frame changed. Nothing is
+    //   refetched while the process runs
+    void Update(lldb::SBProcess process);
+    // Rebuilds on the next Update, e.g. after the formatters changed
+    void Invalidate();
+    const std::vector<uint32_t>& GetRoots() const;
+    Node& GetNode(uint32_t index);
+    // Fetches the next page of children, the first call fetches the first one
+    void FetchPage(uint32_t index);
+    size_t GetNodeCount() const;
+    // Stop the nodes were fetched at
+    uint32_t GetStopId() const;
+    // ValueDiff::FrameKey of the frame the tree is for
+    uint64_t GetFrameKey() const;
+
+  private:
+    uint32_t AddNode(lldb::SBValue value, std::string_view prefix);
+
+  private:
+    uint32_t stopId = UINT32_MAX;
+    uint32_t threadId = UINT32_MAX;
+    uint32_t frameId = UINT32_MAX;
+    uint64_t frameKey = 0;
+    std::vector<Node> nodes;
+    std::vector<uint32_t> roots;
+};
+
+#endif
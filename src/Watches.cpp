@@ -0,0 +1,95 @@
+#include "Watches.hpp"
+#include "Logger.hpp"
+#include "Trace.hpp"
+#include <chrono>
+
+void Watches::Add(const std::string& expression) {
+  std::lock_guard lock(mutex);
+  expressions.push_back(expression);
+  version++;
+}
+
+void Watches::Remove(size_t index) {
+  std::lock_guard lock(mutex);
+  if (index >= expressions.size()) return;
+  expressions.erase(expressions.begin() + index);
+  version++;
+}
+
+std::vector<std::string> Watches::GetExpressions() {
+  std::lock_guard lock(mutex);
+  return expressions;
+}
+
+uint64_t Watches::GetVersion() const {
+  return version.load();
+}
+
+void Watches::SetTimeoutMs(uint32_t timeout_ms) {
+  timeoutMs = timeout_ms;
+  version++;
+}
+
+uint32_t Watches::GetTimeoutMs() const {
+  return timeoutMs.load();
+}
+
+Watches::Snapshot Watches::Evaluate(lldb::SBProcess process, uint32_t thread_index, uint32_t frame_id, const Snapshot* previous) {
+  Trace::Scope t("Evaluate Watches", "watches");
+  using clock = std::chrono::steady_clock;
+  auto start = clock::now();
+
+  Snapshot snapshot;
+  snapshot.version = GetVersion();
+  snapshot.stop_id = process.GetStopID();
+  snapshot.thread_index = thread_index;
+  snapshot.frame_id = frame_id;
+  if (previous && (previous->thread_index != thread_index || previous->frame_id != frame_id))
+    previous = nullptr;
+  auto list = GetExpressions();
+
+  // Only the selected thread runs while an expression does, the timeout
+  //   bounds the ones that call into the target
+  lldb::SBExpressionOptions options;
+  options.SetTimeoutInMicroSeconds(GetTimeoutMs() * 1000);
+  options.SetTryAllThreads(false);
+  options.SetUnwindOnError(true);
+  options.SetIgnoreBreakpoints(true);
+
+  lldb::SBFrame frame = process.GetThreadByIndexID(thread_index).GetFrameAtIndex(frame_id);
+  snapshot.results.reserve(list.size());
+  for (const auto& expression : list) {
+    auto& result = snapshot.results.emplace_back();
+    result.expression = expression;
+    auto evaluate_start = clock::now();
+    lldb::SBValue value = frame.EvaluateExpression(expression.c_str(), options);
+    lldb::SBError error = value.GetError();
+    if (!value.IsValid() || error.Fail()) {
+      result.error = true;
+      result.value = error.GetCString() ? error.GetCString() : "invalid expression";
+      // LLDB's messages end in a newline
+      while (!result.value.empty() && (result.value.back() == '\n' || result.value.back() == '\r'))
+        result.value.pop_back();
+    }
+    else {
+      result.error = false;
+      const char* text = value.GetValue();
+      if (!text) text = value.GetSummary();
+      const char* type = value.GetDisplayTypeName();
+      result.value = text ? text : "<no value>";
+      result.type = type ? type : "";
+    }
+    result.ms = std::chrono::duration<float, std::milli>(clock::now() - evaluate_start).count();
+    result.changed = false;
+    if (previous) {
+      for (const auto& last : previous->results) {
+        if (last.expression == expression) {
+          result.changed = last.value != result.value;
+          break;
+        }
+      }
+    }
+  }
+  snapshot.total_ms = std::chrono::duration<float, std::milli>(clock::now() - start).count();
+  return snapshot;
+}
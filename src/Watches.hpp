@@ -0,0 +1,52 @@
+#ifndef WATCHES_HPP
+#define WATCHES_HPP
+#include <lldb/API/LLDB.h>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Watch expressions, evaluated together in the selected frame once per stop.
+//   The debugger runs Evaluate() on its stop queue and keeps the snapshot
+//   until the next stop, another frame is selected or the list changes
+class Watches {
+  public:
+    struct Result {
+      std::string expression;
+      std::string value; // or the error message
+      std::string type;
+      bool error;
+      bool changed; // since the previous snapshot
+      float ms;
+    };
+    struct Snapshot {
+      uint32_t stop_id = 0;
+      uint32_t thread_index = 0;
+      uint32_t frame_id = 0;
+      uint64_t version = 0;
+      float total_ms = 0.f;
+      std::vector<Result> results;
+    };
+
+  public:
+    void Add(const std::string& expression);
+    void Remove(size_t index);
+    std::vector<std::string> GetExpressions();
+    // Bumped whenever the list or the timeout changes
+    uint64_t GetVersion() const;
+    void SetTimeoutMs(uint32_t timeout_ms);
+    uint32_t GetTimeoutMs() const;
+
+    // Must be called while the process is stopped. Evaluates in the given
+    //   thread and frame, changes are only marked against a previous
+    //   snapshot of the same frame
+    Snapshot Evaluate(lldb::SBProcess process, uint32_t thread_index, uint32_t frame_id, const Snapshot* previous);
+
+  private:
+    std::mutex mutex;
+    std::vector<std::string> expressions;
+    std::atomic<uint64_t> version = 0;
+    std::atomic<uint32_t> timeoutMs = 250;
+};
+
+#endif
@@ -2,6 +2,8 @@
 #include "Args.hpp"
 #include "Logger.hpp"
 #include "Util.hpp"
+#include "Trace.hpp"
+#include "StopLatency.hpp"
 #include <filesystem>
 #include <imgui.h>
 #include <glad/gl.h>
@@ -30,8 +32,12 @@ Window::Window(const std::string& title, int width, int height):
 
   // Setup debugger context
   FileHierarchy& fh = imguiLayer.GetFileHierarchy();
+  std::future<void> indexed;
   if (auto executable = lldb_frontend::Args::Get<std::string>("executable")) {
-    debuggerCtx.SetTarget(debuggerCtx.GetDebugger().CreateTarget(executable->c_str()));
+    {
+      Trace::Scope t("Create Target", "target");
+      debuggerCtx.SetTarget(debuggerCtx.GetDebugger().CreateTarget(executable->c_str()));
+    }
     auto target = debuggerCtx.GetTarget();
     std::filesystem::path fullpath;
     try {
@@ -42,26 +48,8 @@ Window::Window(const std::string& title, int width, int height):
       goto _exit;
     }
 
-    for (size_t i = 0; i < target.GetNumModules(); i++) {
-      lldb::SBModule mod = target.GetModuleAtIndex(i);
-      for (size_t j = 0; j < mod.GetNumCompileUnits(); j++) {
-        lldb::SBCompileUnit cu = mod.GetCompileUnitAtIndex(j);
-        auto directory = cu.GetFileSpec().GetDirectory();
-        auto name = cu.GetFileSpec().GetFilename();
-
-        //NOTE: This is a temporary fix for a null pointer dereference
-        // crash on windows
-        if (!name || !directory) {
-          Logger::Crit("Something went wrong. directory = '{}', name = '{}'", directory ? directory : "null", name ? name : "null");
-          continue;
-        } 
-
-        fh.AddFile(std::filesystem::path(directory) / name);
-      }
-    }
-
-    fh.ComputeTree();
-    // fh.Print();
+    // The files land in the hierarchy through an AddFiles event once indexed
+    indexed = debuggerCtx.IndexTarget(target);
 
     Util::PrintTargetModules(target);
     Util::PrintModuleCompileUnits(target, 0);
@@ -69,6 +57,12 @@ Window::Window(const std::string& title, int width, int height):
 
   // Auto exec
   if (auto autoexec = lldb_frontend::Args::Get<std::string>("autoexec")) {
+    // Breakpoint commands resolve files through the hierarchy, so this is the one
+    //   place that has to wait for the initial index
+    if (indexed.valid()) {
+      indexed.wait();
+      imguiLayer.ApplyQueuedFiles();
+    }
     std::vector<Line> lines;
     if (Util::ReadFileLinesIntoVector(*autoexec, lines)) {
       for (const auto& line : lines) {
@@ -103,6 +97,9 @@ void Window::DebuggerEventListener(const LLDBDebugger::Event& event) {
   else if (auto e = std::get_if<LLDBDebugger::Event::SwitchToFile>(&event.data)) {
     imguiLayer.SwitchToCodeFile(e->filepath);
   }
+  else if (auto e = std::get_if<LLDBDebugger::Event::AddFiles>(&event.data)) {
+    imguiLayer.QueueFiles(e->paths);
+  }
   else {
     std::visit([](auto&& arg) {
       Logger::Crit("Type not handled: {}", typeid(arg).name());
@@ -116,7 +113,10 @@ Window::~Window() {
 }
 
 void Window::WindowLoop() {
+  Trace::SetThreadName("UI");
   while (!glfwWindowShouldClose(m_Window)) {
+    Trace::Scope t("Frame", "ui");
+    StopLatency::FrameStarted();
     imguiLayer.Begin(this);
     imguiLayer.BeginDockspace();
 
@@ -128,6 +128,7 @@ void Window::WindowLoop() {
     imguiLayer.End();
     glfwPollEvents();
     glfwSwapBuffers(m_Window);
+    StopLatency::FramePresented();
   }
 }
 
@@ -12,6 +12,31 @@
 #include "FileHierarchy.hpp"
 #include "LLDBDebugger.hpp"
 #include "TempRedirect.cpp"
+#include "TaskQueue.cpp"
+#include "FrameArena.cpp"
+#include "AllocationCounter.cpp"
+#include "Profiler.cpp"
+#include "Trace.cpp"
+#include "StopLatency.cpp"
+#include "Benchmark.cpp"
+#include "Sampler.cpp"
+#include "Stacks.cpp"
+#include "ProcFS.cpp"
+#include "ThreadMonitor.cpp"
+#include "ResourceMonitor.cpp"
+#include "Tracepoints.cpp"
+#include "Exceptions.cpp"
+#include "Signals.cpp"
+#include "ArrayView.cpp"
+#include "Formatters.cpp"
+#include "VariableTree.cpp"
+#include "Watches.cpp"
+#include "ValueDiff.cpp"
+#include "MemoryCache.cpp"
+#include "HexFormat.cpp"
+#include "MemorySnapshots.cpp"
+#include "Disassembly.cpp"
+#include "Registers.cpp"
 #include "Texture.cpp"
 #include "Resources.cpp"
 #include "Styling.cpp"
@@ -4,6 +4,8 @@
 #include "Resources.hpp"
 #include "Window.hpp"
 #include "Args.hpp"
+#include "Trace.hpp"
+#include "Benchmark.hpp"
 
 int main(int argc, char** argv) {
   //  lldb::SBDebugger::Initialize();
@@ -54,6 +56,26 @@ int main(int argc, char** argv) {
     std::cout << a << std::endl;
   }
 
+  if (auto stops = lldb_frontend::Args::Get<int>("bench-stops")) {
+    return lldb_frontend::Benchmark::RunStopLatency(*stops);
+  }
+  if (auto threads = lldb_frontend::Args::Get<int>("bench-stacks")) {
+    return lldb_frontend::Benchmark::RunStackSnapshot(*threads);
+  }
+  if (auto hits = lldb_frontend::Args::Get<int>("bench-tracepoints")) {
+    return lldb_frontend::Benchmark::RunTracepoints(*hits);
+  }
+  if (auto elements = lldb_frontend::Args::Get<int>("bench-formatters")) {
+    return lldb_frontend::Benchmark::RunFormatters(*elements);
+  }
+  if (auto megabytes = lldb_frontend::Args::Get<int>("bench-memdiff")) {
+    return lldb_frontend::Benchmark::RunMemoryDiff(*megabytes);
+  }
+
+  auto trace_path = lldb_frontend::Args::Get<std::string>("trace");
+  if (trace_path)
+    Trace::SetEnabled(true);
+
   lldb_frontend::Init::InitGlfw();
 
   auto [width, height] = lldb_frontend::Init::GetImGuiIniDimensions();
@@ -63,6 +85,8 @@ int main(int argc, char** argv) {
   lldb_frontend::Resources::LoadAll();
   lldb_frontend::Init::InitImGui(w);
   w.WindowLoop();
+  if (trace_path)
+    Trace::Dump(*trace_path);
   lldb_frontend::Init::DeinitImGui();
   lldb_frontend::Init::TerminateGlfw();
 }
@@ -0,0 +1,85 @@
+#include "LLDBCommandParser.hpp"
+#include <iostream>
+#include <optional>
+#include <string>
+#include <variant>
+
+// Runs commands through LLDB_CommandParser and checks how they parse.
+//   Exits non-zero if any of them doesn't parse the way it should
+
+using Parser = LLDB_CommandParser;
+using Type = Parser::ParsedCommandType;
+
+static Parser parser;
+static int failures = 0;
+
+static void Check(const std::string& command, bool ok, const std::string& what) {
+  if (ok) return;
+  failures++;
+  std::cout << fmt::format("FAIL '{}': {}\n", command, what);
+}
+
+static void Invalid(const std::string& command) {
+  Check(command, parser.Parse(command).type == Type::INVALID, "should be invalid");
+}
+
+static void Handle(const std::string& command, std::optional<bool> pass, std::optional<bool> stop, std::optional<bool> notify) {
+  auto parsed = parser.Parse(command);
+  auto* handle = std::get_if<Parser::SignalHandle>(&parsed.command);
+  Check(command, parsed.type == Type::SIGNAL_HANDLE && handle, "not a handle command");
+  if (!handle) return;
+  Check(command, handle->pass == pass, "pass");
+  Check(command, handle->stop == stop, "stop");
+  Check(command, handle->notify == notify, "notify");
+}
+
+static void Breakpoint(const std::string& command, const std::string& file, int line, const Parser::BPOptions& options) {
+  auto parsed = parser.Parse(command);
+  auto* file_line = std::get_if<Parser::BPFileLine>(&parsed.command);
+  Check(command, parsed.type == Type::BREAKPOINT_FILE_LINE && file_line, "not a file:line breakpoint");
+  if (!file_line) return;
+  Check(command, file_line->file == file && file_line->line == line, "location");
+  Check(command, file_line->options.condition == options.condition, "condition");
+  Check(command, file_line->options.ignore_count == options.ignore_count, "ignore count");
+  Check(command, file_line->options.one_shot == options.one_shot, "one shot");
+}
+
+static void Tracepoint(const std::string& command, const std::string& file, int line, const std::string& message) {
+  auto parsed = parser.Parse(command);
+  auto* tp = std::get_if<Parser::TPFileLine>(&parsed.command);
+  Check(command, parsed.type == Type::TRACEPOINT_FILE_LINE && tp, "not a tracepoint");
+  if (!tp) return;
+  Check(command, tp->file == file && tp->line == line, "location");
+  Check(command, tp->message == message, "message");
+}
+
+int main() {
+  // "notify" starts with "no" but isn't a negated "tify"
+  Handle("handle SIGPROF pass nostop notify", true, false, true);
+  Handle("handle SIGPROF nonotify", std::nullopt, std::nullopt, false);
+  Handle("handle SIGPROF notify", std::nullopt, std::nullopt, true);
+  Handle("handle SIGUSR1 nopass stop", false, true, std::nullopt);
+  Invalid("handle SIGPROF");
+  Invalid("handle SIGPROF tify");
+  Invalid("handle SIGPROF nonopass");
+
+  // The condition is the rest of the command as typed
+  Breakpoint("b main.cpp:12", "main.cpp", 12, {});
+  Breakpoint("b main.cpp:12 -i 3 -o if i == 42", "main.cpp", 12, {.condition = "i == 42", .ignore_count = 3, .one_shot = true});
+  Breakpoint("b main.cpp:12 if s == \"a  b\" && -o", "main.cpp", 12, {.condition = "s == \"a  b\" && -o"});
+  Invalid("b main.cpp:x");
+  Invalid("b main -i");
+  Invalid("b main -i x");
+  Invalid("b main if");
+  Invalid("b main -x");
+
+  // So is the message, spacing included
+  Tracepoint("tp test.cpp:28 x = {x}", "test.cpp", 28, "x = {x}");
+  Tracepoint("tp test.cpp:28   x  =  {x}", "test.cpp", 28, "x  =  {x}");
+  Invalid("tp test.cpp:28");
+  Invalid("tp test.cpp x");
+  Invalid("tp test.cpp:x message");
+
+  std::cout << (failures ? fmt::format("{} parser checks failed\n", failures) : std::string("parser checks passed\n"));
+  return failures ? 1 : 0;
+}
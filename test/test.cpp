@@ -1,7 +1,7 @@
 #include <iostream>
 #include <thread>
 #include "nested/nested.hpp"
-
+#include "test_support.hpp"
 void testFunction() {
   std::cout << "testFunction()" << std::endl;
 }
@@ -23,11 +23,17 @@ int main(int argc, const char **argv) {
     std::cout << "I am in a thread!!" << std::endl; 
   });
 
-  int x = 4;
+  int x = argc > 1 ? std::stoi(argv[1]) : 4;
   while (x > 0) {
     std::cout << "x: " << x << std::endl;
     x--;
   }
 
   if (thread.joinable()) thread.join();
+
+  // Stack snapshot benchmark, see ParkThreads() in test_support
+  if (argc > 2) ParkThreads(std::stoi(argv[2]), 50);
+
+  // Formatter benchmark, see BuildContainers() in test_support
+  if (argc > 3) BuildContainers(std::stoi(argv[3]));
 }
@@ -1,4 +1,82 @@
 #include "test_support.hpp"
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
 
 Support::Support(): x(4), y(3.1f) {}
 Support::~Support() {}
+
+namespace {
+  std::mutex park_mutex;
+  std::condition_variable park_cv;
+  int parked = 0;
+  bool released = false;
+
+  int Descend(int depth) {
+    if (depth == 0) {
+      std::unique_lock lock(park_mutex);
+      parked++;
+      park_cv.notify_all();
+      park_cv.wait(lock, [] { return released; });
+      return 0;
+    }
+    // Work after the call keeps it from becoming a tail call
+    return Descend(depth - 1) + 1;
+  }
+}
+
+void ThreadsParked() {
+  std::cout << "Threads parked" << std::endl;
+}
+
+void ParkThreads(int count, int depth) {
+  std::vector<std::thread> threads;
+  threads.reserve(count);
+  for (int i = 0; i < count; i++)
+    threads.emplace_back([depth] { Descend(depth); });
+  {
+    std::unique_lock lock(park_mutex);
+    park_cv.wait(lock, [count] { return parked == count; });
+  }
+  ThreadsParked();
+  {
+    std::lock_guard lock(park_mutex);
+    released = true;
+  }
+  park_cv.notify_all();
+  for (auto& thread : threads)
+    thread.join();
+}
+
+void ContainersBuilt() {
+  std::cout << "Containers built" << std::endl;
+}
+
+void BuildContainers(int count) {
+  std::vector<int> numbers;
+  std::vector<std::string> names;
+  std::vector<std::vector<int>> rows;
+  std::map<int, std::string> by_id;
+  std::unordered_map<std::string, int> ids;
+  for (int i = 0; i < count; i++) {
+    numbers.push_back(i);
+    names.push_back("name " + std::to_string(i));
+    by_id[i] = names.back();
+    ids[names.back()] = i;
+    if (i % 100 == 0) rows.emplace_back();
+    rows.back().push_back(i);
+  }
+  std::optional<std::string> maybe = "present";
+  std::optional<int> nothing;
+  auto unique = std::make_unique<std::vector<int>>(numbers);
+  auto shared = std::make_shared<std::string>("shared");
+  auto shared_copy = shared;
+  ContainersBuilt();
+}
@@ -10,4 +10,14 @@ class Support {
     float y;
 };
 
+// Parks `count` threads `depth` frames deep, calls ThreadsParked() once they are
+//   all there, then releases them. Used by the stack snapshot benchmark
+void ParkThreads(int count, int depth);
+void ThreadsParked();
+
+// Fills standard containers with `count` elements each, then calls
+//   ContainersBuilt() with them in scope. Used by the formatter benchmark
+void BuildContainers(int count);
+void ContainersBuilt();
+
 #endif